@@ -15,8 +15,7 @@ struct lcd_config config = {
     .timing = {
         .init_delay = 50000,
         .enable_pulse_us = 1,
-        .cmd_delay_us = 50,
-        .clear_delay_us = 2000
+        .exec_us = LCD_EXEC_DEFAULTS
     },
     .display = {
         .cursor_on = false,
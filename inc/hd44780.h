@@ -12,6 +12,7 @@
 
 #include "stm32c0xx_hal.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -36,6 +37,28 @@ extern "C"
         struct lcd_gpio_config rs;      /**< Register select pin */
         struct lcd_gpio_config en;      /**< Enable pin */
         struct lcd_gpio_config data[4]; /**< Data pins (D4-D7) */
+        struct lcd_gpio_config rw;      /**< Read/write pin (port NULL if tied to GND) */
+    };
+
+    /**
+     * @brief Execution time classes, indexing lcd_timing_config::exec_us
+     *
+     * Instruction classes are ordered by the bit that identifies the
+     * instruction, so the highest set bit of a command is its class.
+     */
+    enum lcd_exec
+    {
+        LCD_EXEC_CLEAR,        /**< Clear display */
+        LCD_EXEC_HOME,         /**< Return home */
+        LCD_EXEC_ENTRY_MODE,   /**< Entry mode set */
+        LCD_EXEC_DISPLAY_CTRL, /**< Display on/off control */
+        LCD_EXEC_SHIFT,        /**< Cursor or display shift */
+        LCD_EXEC_FUNCTION_SET, /**< Function set */
+        LCD_EXEC_CGRAM_ADDR,   /**< Set CGRAM address */
+        LCD_EXEC_DDRAM_ADDR,   /**< Set DDRAM address */
+        LCD_EXEC_DATA_WRITE,   /**< Write data to CGRAM or DDRAM */
+        LCD_EXEC_DATA_READ,    /**< Read data from CGRAM or DDRAM */
+        LCD_EXEC_COUNT         /**< Number of classes */
     };
 
     /**
@@ -43,12 +66,34 @@ extern "C"
      */
     struct lcd_timing_config
     {
-        uint32_t init_delay;      /**< Power-on initialization delay */
-        uint32_t enable_pulse_us; /**< Enable pulse width */
-        uint32_t cmd_delay_us;    /**< Command delay */
-        uint32_t clear_delay_us;  /**< Clear display delay */
+        uint32_t init_delay;               /**< Power-on initialization delay */
+        uint32_t enable_pulse_us;          /**< Enable pulse width */
+        uint16_t exec_us[LCD_EXEC_COUNT];  /**< Execution time per instruction class */
     };
 
+/**
+ * @brief Conservative execution times for lcd_timing_config::exec_us
+ *
+ * The datasheet gives 1.52 ms for clear/home and 37 us (plus 4 us address
+ * update for data) for everything else at 270 kHz; these values leave room
+ * for slower clones. Use lcd_autotune() to derive the actual values.
+ * The values are listed in enum lcd_exec order so the initializer is valid
+ * C++ as well.
+ */
+#define LCD_EXEC_DEFAULTS                          \
+    {                                              \
+        2000, /* LCD_EXEC_CLEAR */                 \
+        2000, /* LCD_EXEC_HOME */                  \
+        50,   /* LCD_EXEC_ENTRY_MODE */            \
+        50,   /* LCD_EXEC_DISPLAY_CTRL */          \
+        50,   /* LCD_EXEC_SHIFT */                 \
+        50,   /* LCD_EXEC_FUNCTION_SET */          \
+        50,   /* LCD_EXEC_CGRAM_ADDR */            \
+        50,   /* LCD_EXEC_DDRAM_ADDR */            \
+        50,   /* LCD_EXEC_DATA_WRITE */            \
+        50,   /* LCD_EXEC_DATA_READ */             \
+    }
+
     /**
      * @brief LCD display configuration
      */
@@ -71,6 +116,33 @@ extern "C"
         struct lcd_display_config display; /**< Display configuration */
     };
 
+    /**
+     * @brief LCD wait configuration
+     *
+     * By default every wait spins. With sleep_on_wait, waits of at least
+     * sleep_threshold_us put the core to sleep (WFI) until the deadline.
+     */
+    struct lcd_power_config
+    {
+        bool sleep_on_wait;          /**< Sleep during long waits */
+        uint32_t sleep_threshold_us; /**< Shortest wait that sleeps instead of spinning */
+        /**
+         * Arms a low-power timer to wake the core after the given time, or
+         * NULL to rely on the HAL tick interrupt (1 ms granularity).
+         */
+        void (*arm_wakeup)(uint32_t us);
+    };
+
+    /**
+     * @brief LCD wait statistics, an energy proxy
+     */
+    struct lcd_power_stats
+    {
+        uint32_t spin_us;     /**< Time spent in busy-wait loops */
+        uint32_t sleep_us;    /**< Time spent sleeping */
+        uint32_t sleep_count; /**< Number of WFI entries */
+    };
+
     /**
      * @brief LCD cursor position structure
      */
@@ -80,12 +152,19 @@ extern "C"
         uint8_t column; /**< Column (0-15) */
     };
 
+/**
+ * @brief LCD dimensions
+ */
+#define LCD_ROWS 2     /**< Number of display rows */
+#define LCD_COLUMNS 16 /**< Number of display columns */
+
 /**
  * @brief Error codes for LCD operations
  */
 #define LCD_SUCCESS 0    /**< Operation completed successfully */
 #define LCD_ERR_PARAM -1 /**< Invalid parameter provided */
 #define LCD_ERR_BUSY -2  /**< LCD controller is busy */
+#define LCD_ERR_UNSUPPORTED -3 /**< Operation needs the R/W pin */
 
     /**
      * @brief Initialize LCD with given configuration
@@ -97,6 +176,45 @@ extern "C"
      */
     int lcd_init(const struct lcd_config *config);
 
+    /**
+     * @brief Start non-blocking LCD initialization
+     *
+     * Configures the GPIO pins and arms the power-on delay; the rest of the
+     * sequence is run by lcd_init_poll(). Other LCD calls return
+     * LCD_ERR_BUSY until initialization completes.
+     *
+     * @param config Pointer to LCD configuration structure
+     *
+     * @retval LCD_SUCCESS If initialization was started
+     * @retval LCD_ERR_PARAM If invalid config parameters
+     */
+    int lcd_init_start(const struct lcd_config *config);
+
+    /**
+     * @brief Advance non-blocking LCD initialization
+     *
+     * Call periodically from the main loop or a timer interrupt after
+     * lcd_init_start(). Returns without waiting while a delay is pending.
+     *
+     * @retval LCD_SUCCESS If the LCD is initialized
+     * @retval LCD_ERR_BUSY If initialization is still in progress
+     */
+    int lcd_init_poll(void);
+
+    /**
+     * @brief Initialize an already powered LCD (warm restart)
+     *
+     * Skips the power-on delays for a controller that kept its supply across
+     * an MCU reset. With an R/W pin the displayed text is kept, otherwise the
+     * display is cleared.
+     *
+     * @param config Pointer to LCD configuration structure
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If invalid config parameters
+     */
+    int lcd_init_warm(const struct lcd_config *config);
+
     /**
      * @brief Clear LCD display
      *
@@ -121,6 +239,7 @@ extern "C"
      *
      * @retval LCD_SUCCESS    If successful
      * @retval LCD_ERR_PARAM  If row or column values are out of valid range
+     * @retval LCD_ERR_BUSY   If LCD is busy
      */
     int lcd_set_cursor_xy(uint8_t row, uint8_t column);
     /**
@@ -140,17 +259,54 @@ extern "C"
      *
      * @retval LCD_SUCCESS If successful
      * @retval LCD_ERR_PARAM If str is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
      */
     int lcd_write_string(const char *str);
 
+    /**
+     * @brief Write buffer to LCD at a position
+     *
+     * Sets the address and RS once per row and streams the characters,
+     * continuing at the start of the next row (and wrapping from the last
+     * row to the first) when a row is full.
+     *
+     * @param row    Row number (0-1 for 16x2 LCD)
+     * @param column Column number (0-15 for 16x2 LCD)
+     * @param buf    Character codes to write
+     * @param len    Number of characters, at most LCD_ROWS * LCD_COLUMNS
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If position is out of range, buf is NULL or len too large
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_write_buffer(uint8_t row, uint8_t column, const uint8_t *buf, size_t len);
+
+    /**
+     * @brief Write rectangular block of characters to LCD
+     *
+     * @param row    Top row number
+     * @param column Left column number
+     * @param height Number of rows in the block
+     * @param width  Number of columns in the block
+     * @param buf    Character codes, height * width bytes row-major
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If the block does not fit the display or buf is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_write_region(uint8_t row, uint8_t column, uint8_t height, uint8_t width, const uint8_t *buf);
+
     /**
      * @brief Create custom character
      *
+     * The cursor position is preserved.
+     *
      * @param location Character code (0-7)
      * @param pattern Character pattern (8 bytes)
      *
      * @retval LCD_SUCCESS If successful
      * @retval LCD_ERR_PARAM If location > 7 or pattern is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
      */
     int lcd_create_char(uint8_t location, const uint8_t pattern[8]);
 
@@ -161,9 +317,159 @@ extern "C"
      *
      * @retval LCD_SUCCESS If successful
      * @retval LCD_ERR_PARAM If config is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
      */
     int lcd_set_display(const struct lcd_display_config *config);
 
+    /**
+     * @brief Replace the timing configuration
+     *
+     * Takes effect for the next transfer, e.g. to apply the result of
+     * lcd_autotune() or timings stored from an earlier run.
+     *
+     * @param timing Pointer to timing configuration structure
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If timing is NULL
+     */
+    int lcd_set_timing(const struct lcd_timing_config *timing);
+
+    /**
+     * @brief Configure how the driver waits
+     *
+     * May be called before lcd_init() so the power-on delay sleeps too.
+     *
+     * @param config Pointer to power configuration structure
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If config is NULL
+     */
+    int lcd_set_power_mode(const struct lcd_power_config *config);
+
+    /**
+     * @brief Get the time spent spinning and sleeping in waits
+     *
+     * @param stats Pointer receiving the statistics
+     * @param reset Clear the statistics after reading them
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If stats is NULL
+     */
+    int lcd_get_power_stats(struct lcd_power_stats *stats, bool reset);
+
+    /**
+     * @brief Measure the execution times of the connected panel
+     *
+     * Issues each instruction class a few times and times it by polling the
+     * busy flag, then adds the margin. The display contents and cursor are
+     * restored afterwards. The result is not applied; pass it to
+     * lcd_set_timing() and/or store it for the next lcd_init().
+     *
+     * @param margin_percent Safety margin added to the measured times
+     * @param timing         Pointer receiving the derived timing configuration
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If timing is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy or the busy flag never cleared or never read high
+     * @retval LCD_ERR_UNSUPPORTED If no R/W pin is configured
+     */
+    int lcd_autotune(uint8_t margin_percent, struct lcd_timing_config *timing);
+
+    /**
+     * @brief Update part of a row, writing only changed characters
+     *
+     * Compares the characters with the display shadow and transmits only
+     * those that differ, in address order. The address is set only where
+     * the cursor is not already at the next changed cell. The cursor is left
+     * after the last character written, if any.
+     *
+     * @param row    Row number (0-1 for 16x2 LCD)
+     * @param column Column of the first character
+     * @param cells  Character codes to show
+     * @param len    Number of characters, must fit on the row
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If the range is outside the row or cells is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_update_row(uint8_t row, uint8_t column, const uint8_t *cells, uint8_t len);
+
+    /**
+     * @brief Read a character from the display shadow
+     *
+     * Returns the character code last written to the given position. The
+     * LCD itself is not accessed.
+     *
+     * @param row    Row number (0-1 for 16x2 LCD)
+     * @param column Column number (0-15 for 16x2 LCD)
+     * @param c      Pointer receiving the character code
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If position is out of range or c is NULL
+     */
+    int lcd_get_char(uint8_t row, uint8_t column, uint8_t *c);
+
+    /**
+     * @brief Register a holder of CGRAM character codes
+     *
+     * Buffers that are shown later (windows, frame buffers) register a
+     * callback reporting the CGRAM locations they reference, so patterns
+     * they still need are not replaced, e.g. by UTF-8 fallback glyphs.
+     * Registering the same callback again has no effect.
+     *
+     * @param holder Callback returning a bit mask of referenced locations
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If holder is NULL or no more holders can be registered
+     */
+    int lcd_cgram_add_holder(uint8_t (*holder)(void));
+
+    /**
+     * @brief Get the CGRAM locations in use
+     *
+     * @return Bit mask of locations referenced by the display or by a registered holder
+     */
+    uint8_t lcd_cgram_in_use(void);
+
+    /**
+     * @brief Get the CGRAM locations referenced by a buffer
+     *
+     * Character codes 0x08-0x0F count as their aliases 0x00-0x07.
+     *
+     * @param cells Character codes
+     * @param len   Number of character codes
+     *
+     * @return Bit mask of referenced locations
+     */
+    uint8_t lcd_cgram_refs(const uint8_t *cells, size_t len);
+
+    /**
+     * @brief Scrub one row of the display against the shadow copy
+     *
+     * Each call handles the next row, followed by one step for the CGRAM
+     * patterns, then starts over. With an R/W pin the controller memory is
+     * read back and only mismatching cells are rewritten; without one the
+     * whole row is rewritten from the shadow. Call it periodically (e.g. from
+     * the main loop) to recover from corruption without blanking the screen.
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_scrub_step(void);
+
+    /**
+     * @brief Resynchronize the controller without a full power-on sequence
+     *
+     * Realigns the 4-bit interface and re-issues the function set, entry mode
+     * and display control instructions, then reloads the CGRAM patterns from
+     * the shadow copy. DDRAM is left untouched; subsequent lcd_scrub_step()
+     * calls bring it back in line with the shadow.
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_resync(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief Double-buffered drawing for LCD 16x2 Display Driver
+ *
+ * This file contains the API for drawing into a back buffer and presenting
+ * it as a whole. The front buffer is the display shadow kept by the driver,
+ * so presenting transmits only the cells that differ from what is shown.
+ */
+
+#ifndef HD44780_FRAME_H_
+#define HD44780_FRAME_H_
+
+#include "hd44780.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Screen contents
+     */
+    struct lcd_frame
+    {
+        uint8_t cells[LCD_ROWS][LCD_COLUMNS]; /**< Character codes, row-major */
+    };
+
+    /**
+     * @brief Get the back buffer
+     *
+     * The back buffer starts filled with spaces. Drawing into it does not
+     * affect the display until lcd_frame_present() is called.
+     *
+     * @return Pointer to the back buffer
+     */
+    struct lcd_frame *lcd_frame_back(void);
+
+    /**
+     * @brief Fill the back buffer with spaces
+     */
+    void lcd_frame_clear(void);
+
+    /**
+     * @brief Write a string into the back buffer
+     *
+     * Characters beyond the end of the row are clipped.
+     *
+     * @param row    Row number (0-1 for 16x2 LCD)
+     * @param column Column number (0-15 for 16x2 LCD)
+     * @param str    Null-terminated string to write
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If position is out of range or str is NULL
+     */
+    int lcd_frame_print(uint8_t row, uint8_t column, const char *str);
+
+    /**
+     * @brief Present the back buffer
+     *
+     * Takes an atomic snapshot of the back buffer and transmits the cells
+     * that differ from the display. Safe to call from interrupt context,
+     * where the snapshot is only queued. A frame queued while another one
+     * is being transmitted replaces any frame still waiting, so only the
+     * latest frame is sent.
+     *
+     * @retval LCD_SUCCESS If the frame was transmitted
+     * @retval LCD_ERR_BUSY If the frame was queued for lcd_frame_service()
+     */
+    int lcd_frame_present(void);
+
+    /**
+     * @brief Transmit a queued frame
+     *
+     * Call from the main loop, or from a timer interrupt if the LCD is not
+     * driven directly from other contexts.
+     *
+     * @retval LCD_SUCCESS If no frame is waiting or it was transmitted
+     * @retval LCD_ERR_BUSY If the LCD or the transmitter is busy
+     */
+    int lcd_frame_service(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HD44780_FRAME_H_ */
@@ -0,0 +1,85 @@
+/**
+ * @file
+ * @brief Text layout for LCD 16x2 Display Driver
+ *
+ * This file contains the API for laying text out in a window with
+ * word-wrap, alignment, ellipsis truncation and pagination. Layouts of
+ * texts up to LCD_LAYOUT_CACHE_TEXT characters are cached by content, so
+ * showing a message again skips the layout work.
+ */
+
+#ifndef HD44780_LAYOUT_H_
+#define HD44780_LAYOUT_H_
+
+#include "hd44780_window.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Maximum number of lines a text is laid out to
+ */
+#define LCD_LAYOUT_MAX_LINES 16
+
+/**
+ * @brief Number of layouts kept in the cache
+ */
+#define LCD_LAYOUT_CACHE_SIZE 4
+
+/**
+ * @brief Longest text kept in the cache, longer texts are laid out on every call
+ */
+#define LCD_LAYOUT_CACHE_TEXT 64
+
+/**
+ * @brief Marker appended to text that was cut off
+ */
+#define LCD_LAYOUT_ELLIPSIS "..."
+
+    /**
+     * @brief Horizontal alignment of text lines
+     */
+    enum lcd_align
+    {
+        LCD_ALIGN_LEFT,   /**< Align to the left edge */
+        LCD_ALIGN_CENTER, /**< Center, leaning left */
+        LCD_ALIGN_RIGHT   /**< Align to the right edge */
+    };
+
+    /**
+     * @brief Text layout style
+     */
+    struct lcd_layout_style
+    {
+        enum lcd_align align; /**< Horizontal alignment */
+        bool wrap;            /**< Wrap long lines at spaces (otherwise cut them off) */
+        bool ellipsis;        /**< Mark cut off text with LCD_LAYOUT_ELLIPSIS */
+    };
+
+    /**
+     * @brief Lay text out in a window
+     *
+     * Breaks the text at newlines and, with wrap, at spaces so that every
+     * line fits the window width, and writes one page of window height
+     * lines into the window. Call lcd_window_flush() to update the display;
+     * only cells that changed are transmitted.
+     *
+     * @param win        Pointer to window structure
+     * @param text       Null-terminated text of character codes
+     * @param style      Pointer to layout style structure
+     * @param page       Page to show, starting at 0
+     * @param page_count Pointer receiving the number of pages, may be NULL
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If a pointer is NULL, the window is not open, the text is too long or page is out of range
+     */
+    int lcd_layout_show(struct lcd_window *win, const char *text, const struct lcd_layout_style *style,
+                        uint8_t page, uint8_t *page_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HD44780_LAYOUT_H_ */
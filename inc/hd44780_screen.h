@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @brief Pre-encoded static screens for LCD 16x2 Display Driver
+ *
+ * This file contains the API for replaying screens that were encoded ahead
+ * of time into a compact stream kept in flash. A stream is a sequence of
+ * runs, each made of the DDRAM address instruction, the run length and the
+ * character codes, terminated by LCD_SCREEN_END. Streams are generated by
+ * tools/gen_screen.py or written by hand with LCD_SCREEN_RUN().
+ */
+
+#ifndef HD44780_SCREEN_H_
+#define HD44780_SCREEN_H_
+
+#include "hd44780.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Header of a run of len characters starting at row, column
+ */
+#define LCD_SCREEN_RUN(row, column, len) (0x80 | ((row) ? 0x40 : 0x00) | (column)), (len)
+
+/**
+ * @brief End of a screen stream
+ */
+#define LCD_SCREEN_END 0x00
+
+    /**
+     * @brief Replay a screen stream
+     *
+     * Sends every run as one address set followed by one data run. The
+     * stream is checked as a whole first; an invalid one writes nothing.
+     *
+     * @param stream Screen stream
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If stream is NULL or contains a run outside the display
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_screen_play(const uint8_t *stream);
+
+    /**
+     * @brief Load a screen stream, updating only cells that differ
+     *
+     * Like lcd_screen_play() but compares every run with the display shadow
+     * and transmits only the changed characters.
+     *
+     * @param stream Screen stream
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If stream is NULL or contains a run outside the display
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_screen_load(const uint8_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HD44780_SCREEN_H_ */
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief UTF-8 text support for LCD 16x2 Display Driver
+ *
+ * This file contains the API for writing UTF-8 encoded text. Codepoints are
+ * translated to the character ROM of the controller through lookup tables;
+ * codepoints missing from ROM are drawn with glyphs loaded into CGRAM on
+ * demand.
+ */
+
+#ifndef HD44780_UTF8_H_
+#define HD44780_UTF8_H_
+
+#include "hd44780.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Character ROM variants
+     */
+    enum lcd_rom
+    {
+        LCD_ROM_A00, /**< Japanese standard font (katakana) */
+        LCD_ROM_A02  /**< European standard font (Latin-1) */
+    };
+
+    /**
+     * @brief UTF-8 translation configuration
+     */
+    struct lcd_utf8_config
+    {
+        enum lcd_rom rom;   /**< Character ROM fitted to the controller */
+        uint8_t first_slot; /**< First CGRAM location used for fallback glyphs */
+        uint8_t slot_count; /**< Number of CGRAM locations used for fallback glyphs */
+        /**
+         * Returns the 8-byte pattern for a codepoint missing from ROM, or
+         * NULL if there is none. May be NULL to disable CGRAM fallback.
+         */
+        const uint8_t *(*glyph)(uint32_t codepoint);
+    };
+
+/**
+ * @brief Character code shown for codepoints that cannot be displayed
+ */
+#define LCD_UTF8_REPLACEMENT '?'
+
+    /**
+     * @brief Configure UTF-8 translation
+     *
+     * CGRAM locations in the fallback range are managed by the translator
+     * and should not be written with lcd_create_char().
+     *
+     * @param config Pointer to UTF-8 configuration structure
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If config is NULL or the slot range exceeds CGRAM
+     */
+    int lcd_utf8_init(const struct lcd_utf8_config *config);
+
+    /**
+     * @brief Translate a codepoint to a character code
+     *
+     * Loads a fallback glyph into CGRAM if the codepoint is not in ROM.
+     * Codepoints that can't be displayed translate to LCD_UTF8_REPLACEMENT.
+     * A fallback code stays valid while it is on the display, in an open
+     * window or in the frame buffers; codes kept in other buffers need an
+     * lcd_cgram_add_holder() callback, or their glyph may be replaced.
+     *
+     * @param codepoint Unicode codepoint
+     * @param code      Pointer receiving the character code
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If code is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_utf8_translate(uint32_t codepoint, uint8_t *code);
+
+    /**
+     * @brief Write UTF-8 string to LCD
+     *
+     * @param str Null-terminated UTF-8 string to write
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If str is NULL
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_write_utf8(const char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HD44780_UTF8_H_ */
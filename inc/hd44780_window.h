@@ -0,0 +1,158 @@
+/**
+ * @file
+ * @brief Window compositor for LCD 16x2 Display Driver
+ *
+ * This file contains the API for dividing the display into independently
+ * updated rectangular windows. Windows are drawn into their own buffers
+ * and composited by z-order; a flush transmits only the cells that changed
+ * on the display.
+ */
+
+#ifndef HD44780_WINDOW_H_
+#define HD44780_WINDOW_H_
+
+#include "hd44780.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Window structure
+     *
+     * Allocated by the caller and set up with lcd_window_open(). The fields
+     * are managed by the compositor and should be treated as read-only.
+     */
+    struct lcd_window
+    {
+        uint8_t row;                /**< Top row on the display */
+        uint8_t column;             /**< Left column on the display */
+        uint8_t height;             /**< Height in rows */
+        uint8_t width;              /**< Width in columns */
+        uint8_t z;                  /**< Stacking order, higher is in front */
+        bool visible;               /**< Window is shown */
+        uint8_t *cells;             /**< height * width character codes, row-major */
+        uint32_t dirty[LCD_ROWS];   /**< Changed cells per window row */
+        struct lcd_window *next;    /**< Next window, front to back */
+    };
+
+    /**
+     * @brief Open a window
+     *
+     * The window starts visible and filled with spaces.
+     *
+     * @param win    Pointer to window structure
+     * @param row    Top row on the display
+     * @param column Left column on the display
+     * @param height Height in rows
+     * @param width  Width in columns
+     * @param z      Stacking order, higher is in front
+     * @param cells  Buffer of height * width bytes for the window contents
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If the window does not fit the display, a pointer is NULL or the window is already open
+     */
+    int lcd_window_open(struct lcd_window *win, uint8_t row, uint8_t column, uint8_t height, uint8_t width,
+                        uint8_t z, uint8_t *cells);
+
+    /**
+     * @brief Close a window, uncovering what is below it
+     *
+     * @param win Pointer to window structure
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If win is NULL or not open
+     */
+    int lcd_window_close(struct lcd_window *win);
+
+    /**
+     * @brief Show or hide a window
+     *
+     * @param win     Pointer to window structure
+     * @param visible Show the window (true) or hide it (false)
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If win is NULL or not open
+     */
+    int lcd_window_show(struct lcd_window *win, bool visible);
+
+    /**
+     * @brief Change the stacking order of a window
+     *
+     * @param win Pointer to window structure
+     * @param z   Stacking order, higher is in front
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If win is NULL or not open
+     */
+    int lcd_window_set_z(struct lcd_window *win, uint8_t z);
+
+    /**
+     * @brief Write character codes into a window
+     *
+     * Characters beyond the right edge of the window are clipped.
+     *
+     * @param win    Pointer to window structure
+     * @param row    Row within the window
+     * @param column Column within the window
+     * @param buf    Character codes to write
+     * @param len    Number of characters
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If a pointer is NULL, the window is not open or the position is outside it
+     */
+    int lcd_window_write(struct lcd_window *win, uint8_t row, uint8_t column, const uint8_t *buf, size_t len);
+
+    /**
+     * @brief Write a string into a window
+     *
+     * Characters beyond the right edge of the window are clipped.
+     *
+     * @param win    Pointer to window structure
+     * @param row    Row within the window
+     * @param column Column within the window
+     * @param str    Null-terminated string to write
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If a pointer is NULL, the window is not open or the position is outside it
+     */
+    int lcd_window_print(struct lcd_window *win, uint8_t row, uint8_t column, const char *str);
+
+    /**
+     * @brief Fill a window with a character
+     *
+     * @param win Pointer to window structure
+     * @param c   Character code to fill with
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_PARAM If win is NULL or not open
+     */
+    int lcd_window_fill(struct lcd_window *win, uint8_t c);
+
+    /**
+     * @brief Check whether a window is open
+     *
+     * @param win Pointer to window structure
+     *
+     * @return true if the window has been opened and not closed since
+     */
+    bool lcd_window_is_open(const struct lcd_window *win);
+
+    /**
+     * @brief Composite all windows and update the display
+     *
+     * Only cells that changed since the last flush are composited, and only
+     * those that differ from what the display shows are transmitted, in
+     * address order.
+     *
+     * @retval LCD_SUCCESS If successful
+     * @retval LCD_ERR_BUSY If LCD is busy
+     */
+    int lcd_window_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HD44780_WINDOW_H_ */
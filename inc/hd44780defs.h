@@ -31,11 +31,39 @@
 #define LCD_ONE_LINE            0x00
 #define LCD_5x10_DOTS           0x04
 #define LCD_5x8_DOTS            0x00
+#define LCD_ENTRY_INCREMENT     0x02
+#define LCD_SHIFT_RIGHT         0x04
 
-/* LCD dimensions */
-#define LCD_ROWS                2
-#define LCD_COLUMNS             16
+/* Non-blocking init: waits below this are spun instead of tick-timed */
+#define LCD_INIT_SPIN_LIMIT_US  1000
+
+/* Autotune: samples per instruction class and busy flag timeout */
+#define LCD_AUTOTUNE_SAMPLES    4
+#define LCD_AUTOTUNE_TIMEOUT_US 20000
+
+/* Autotune: times below the datasheet value divided by this mean a dead busy flag */
+#define LCD_AUTOTUNE_MIN_DIVISOR 4
+
+/* Address counter update after the busy flag clears on data access (tADD) */
+#define LCD_ADDRESS_UPDATE_US   4
+
+/* Callbacks reporting CGRAM codes held in off-screen buffers */
+#define LCD_CGRAM_HOLDERS       4
+
+/* Sleeping waits: HAL tick period waking the core without a wakeup hook */
+#define LCD_SYSTICK_PERIOD_US   1000
+
+/* LCD row addresses */
 #define LCD_ROW_OFFSET_0        0x00
 #define LCD_ROW_OFFSET_1        0x40
 
+/* LCD memory layout */
+#define LCD_DDRAM_LINE_SIZE     0x28
+#define LCD_DDRAM_SIZE          0x50
+#define LCD_DDRAM_ADDR_MASK     0x7F
+#define LCD_CGRAM_CHARS         8
+#define LCD_CGRAM_ROWS          8
+#define LCD_CGRAM_ADDR_MASK     0x3F
+#define LCD_BUSY_FLAG           0x80
+
 #endif /* HD44780_DEFS_H_ */
\ No newline at end of file
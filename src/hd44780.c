@@ -9,23 +9,83 @@
 
 #include "hd44780.h"
 #include "hd44780defs.h"
+#include <string.h>
 
 /* Static configuration storage */
 static struct lcd_config current_config;
 
+/* Shadow copy of the visible DDRAM cells and the CGRAM patterns */
+static uint8_t lcd_shadow[LCD_ROWS][LCD_COLUMNS];
+static uint8_t lcd_cgram_shadow[LCD_CGRAM_CHARS][LCD_CGRAM_ROWS];
+static uint8_t lcd_cgram_loaded;
+
+/* Callbacks reporting CGRAM codes held outside the display */
+static uint8_t (*lcd_cgram_holders[LCD_CGRAM_HOLDERS])(void);
+
+/* Mirror of the controller address counter */
+static uint8_t lcd_address;
+static bool lcd_address_cgram;
+
+/* Low-power wait configuration and statistics */
+static struct lcd_power_config lcd_power;
+static struct lcd_power_stats lcd_power_stats;
+
+/* Initialization sequence state */
+enum lcd_init_state
+{
+    LCD_INIT_IDLE,
+    LCD_INIT_POWER_UP,
+    LCD_INIT_WAKE_1,
+    LCD_INIT_WAKE_2,
+    LCD_INIT_WAKE_3,
+    LCD_INIT_CLEAR,
+    LCD_INIT_DONE
+};
+
+/* Shared with lcd_init_poll() called from a timer interrupt */
+static volatile enum lcd_init_state lcd_init_state = LCD_INIT_IDLE;
+static volatile uint32_t lcd_init_tick;
+static volatile uint32_t lcd_init_wait_ms;
+
+/* Next scrub step (rows first, then CGRAM) */
+static uint8_t lcd_scrub_index;
+
+static const uint8_t lcd_row_offsets[LCD_ROWS] = {LCD_ROW_OFFSET_0, LCD_ROW_OFFSET_1};
+
 /* Private function prototypes */
+static void lcd_init_hw(const struct lcd_config *config);
+static uint32_t lcd_init_step(void);
+static void lcd_init_wait(uint32_t us);
+static void lcd_realign_interface(void);
 static void lcd_gpio_write(const struct lcd_gpio_config *gpio, GPIO_PinState state);
 static void lcd_write_4bits(uint8_t data);
 static void lcd_write_byte(uint8_t data, bool is_cmd);
+static void lcd_send_byte(uint8_t data, bool is_cmd);
+static void lcd_write_data(const uint8_t *buf, size_t len);
+static void lcd_write_row(uint8_t row, uint8_t column, const uint8_t *buf, size_t len);
+static enum lcd_exec lcd_exec_class(uint8_t cmd);
+static uint8_t lcd_read_4bits(void);
+static uint8_t lcd_read_byte(bool is_cmd);
+static uint8_t lcd_receive_byte(bool is_cmd);
+static uint32_t lcd_time_us(void);
+static uint32_t lcd_wait_busy_us(void);
+static void lcd_set_data_direction(uint32_t mode);
+static uint8_t lcd_next_ddram_address(uint8_t address);
+static void lcd_track_byte(uint8_t data, bool is_cmd);
+static void lcd_set_address(uint8_t address, bool cgram);
+static uint8_t lcd_function_set_cmd(const struct lcd_display_config *config);
+static uint8_t lcd_display_ctrl_cmd(const struct lcd_display_config *config);
 static void lcd_pulse_enable(void);
 static void lcd_delay_us(uint32_t us);
+static void lcd_spin_us(uint32_t us);
+static void lcd_sleep_us(uint32_t us);
 
 /**
  * @brief Initializes the LCD with the provided configuration
  *
  * This function configures the GPIO pins and initializes the LCD
  * in 4-bit mode with the specified settings, including display control
- * and cursor settings.
+ * and cursor settings. It blocks until the power-on sequence completes.
  *
  * @param config Pointer to the configuration structure
  * @return LCD_SUCCESS if initialization was successful, LCD_ERR_PARAM if invalid parameters
@@ -37,73 +97,120 @@ int lcd_init(const struct lcd_config *config)
         return LCD_ERR_PARAM;
     }
 
-    /* Store configuration */
-    current_config = *config;
-
-    /* Configure GPIO pins */
-    GPIO_InitTypeDef gpio_init = {0};
-    gpio_init.Mode = GPIO_MODE_OUTPUT_PP;
-    gpio_init.Pull = GPIO_NOPULL;
-    gpio_init.Speed = GPIO_SPEED_FREQ_LOW;
-
-    /* Initialize RS pin */
-    gpio_init.Pin = config->pins.rs.pin;
-    HAL_GPIO_Init(config->pins.rs.port, &gpio_init);
+    lcd_init_hw(config);
 
-    /* Initialize EN pin */
-    gpio_init.Pin = config->pins.en.pin;
-    HAL_GPIO_Init(config->pins.en.port, &gpio_init);
+    /* Wait for power-up, sleeping through it in low-power mode */
+    lcd_delay_us(config->timing.init_delay);
 
-    /* Initialize Data pins */
-    for (int i = 0; i < 4; i++)
+    /* Run the power-on sequence, waiting between steps */
+    lcd_init_state = LCD_INIT_POWER_UP;
+    while (lcd_init_state != LCD_INIT_DONE)
     {
-        gpio_init.Pin = config->pins.data[i].pin;
-        HAL_GPIO_Init(config->pins.data[i].port, &gpio_init);
+        lcd_delay_us(lcd_init_step());
     }
 
-    /* Wait for power-up */
-    HAL_Delay(config->timing.init_delay / 1000U);
-
-    /* Initialize in 4-bit mode */
-    lcd_write_4bits(0x03);
-    lcd_delay_us(4500);
-    lcd_write_4bits(0x03);
-    lcd_delay_us(4500);
-    lcd_write_4bits(0x03);
-    lcd_delay_us(150);
-    lcd_write_4bits(0x02);
+    return LCD_SUCCESS;
+}
 
-    /* Set function */
-    uint8_t function = LCD_CMD_FUNCTION_SET;
-    if (config->display.two_lines)
+/**
+ * @brief Starts a non-blocking initialization of the LCD
+ *
+ * This function configures the GPIO pins and arms the power-on delay.
+ * The remaining sequence is driven by lcd_init_poll(), which can be called
+ * from the main loop or a periodic timer while other peripherals start up.
+ *
+ * @param config Pointer to the configuration structure
+ * @return LCD_SUCCESS if initialization was started, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_init_start(const struct lcd_config *config)
+{
+    if (config == NULL)
     {
-        function |= LCD_TWO_LINE;
+        return LCD_ERR_PARAM;
     }
-    if (config->display.big_font)
+
+    lcd_init_hw(config);
+    lcd_init_wait(config->timing.init_delay);
+    lcd_init_state = LCD_INIT_POWER_UP;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Advances a non-blocking initialization
+ *
+ * This function runs every step whose wait has elapsed. Waits shorter than
+ * LCD_INIT_SPIN_LIMIT_US are spun inline, longer ones are timed with the
+ * HAL tick so the call returns immediately while they are pending.
+ *
+ * @return LCD_SUCCESS once the LCD is ready, LCD_ERR_BUSY while initialization is in progress
+ */
+int lcd_init_poll(void)
+{
+    while (lcd_init_state != LCD_INIT_DONE)
     {
-        function |= LCD_5x10_DOTS;
+        if (lcd_init_state == LCD_INIT_IDLE || HAL_GetTick() - lcd_init_tick < lcd_init_wait_ms)
+        {
+            return LCD_ERR_BUSY;
+        }
+
+        uint32_t wait_us = lcd_init_step();
+        if (wait_us < LCD_INIT_SPIN_LIMIT_US)
+        {
+            lcd_delay_us(wait_us);
+            lcd_init_wait_ms = 0;
+        }
+        else
+        {
+            lcd_init_wait(wait_us);
+        }
     }
-    lcd_write_byte(function, true);
+    return LCD_SUCCESS;
+}
 
-    /* Set display control */
-    uint8_t display = LCD_CMD_DISPLAY_CTRL;
-    if (config->display.display_on)
+/**
+ * @brief Initializes an LCD that is already powered and running
+ *
+ * This function is meant for restarts of the MCU alone (e.g. after a
+ * watchdog reset) where the controller kept its supply. It skips the
+ * power-on delays and realigns the 4-bit interface instead. With an RW pin
+ * the current DDRAM contents are adopted into the shadow copy so the screen
+ * is not blanked; without one the display is cleared.
+ *
+ * @param config Pointer to the configuration structure
+ * @return LCD_SUCCESS if initialization was successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_init_warm(const struct lcd_config *config)
+{
+    if (config == NULL)
     {
-        display |= LCD_DISPLAY_ON;
+        return LCD_ERR_PARAM;
     }
-    if (config->display.cursor_on)
+
+    lcd_init_hw(config);
+    lcd_realign_interface();
+
+    lcd_write_byte(lcd_function_set_cmd(&config->display), true);
+    lcd_write_byte(LCD_CMD_ENTRY_MODE | LCD_ENTRY_INCREMENT, true);
+    lcd_write_byte(lcd_display_ctrl_cmd(&config->display), true);
+
+    if (config->pins.rw.port != NULL)
     {
-        display |= LCD_CURSOR_ON;
+        for (int row = 0; row < LCD_ROWS; row++)
+        {
+            lcd_write_byte(LCD_CMD_DDRAM_ADDR | lcd_row_offsets[row], true);
+            for (int col = 0; col < LCD_COLUMNS; col++)
+            {
+                lcd_shadow[row][col] = lcd_read_byte(false);
+            }
+        }
+        lcd_write_byte(LCD_CMD_DDRAM_ADDR, true);
     }
-    if (config->display.cursor_blink)
+    else
     {
-        display |= LCD_BLINK_ON;
+        lcd_write_byte(LCD_CMD_CLEAR, true);
     }
-    lcd_write_byte(display, true);
-
-    /* Clear display */
-    lcd_clear();
 
+    lcd_init_state = LCD_INIT_DONE;
     return LCD_SUCCESS;
 }
 
@@ -117,8 +224,12 @@ int lcd_init(const struct lcd_config *config)
  */
 int lcd_home(void)
 {
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
     lcd_write_byte(LCD_CMD_HOME, true);
-    lcd_delay_us(current_config.timing.cmd_delay_us);
     return LCD_SUCCESS;
 }
 
@@ -138,6 +249,11 @@ int lcd_set_cursor_xy(uint8_t row, uint8_t column)
         return LCD_ERR_PARAM;
     }
 
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
     uint8_t address;
     switch (row)
     {
@@ -160,6 +276,8 @@ int lcd_set_cursor_xy(uint8_t row, uint8_t column)
  *
  * This function allows the creation of a custom character to be used
  * on the LCD display. The custom character pattern is stored in CGRAM.
+ * The cursor position is preserved, and a pattern identical to the one
+ * already stored at the location is not sent again.
  *
  * @param location Location in CGRAM (0 to 7)
  * @param pattern Array of 8 bytes representing the character pattern
@@ -172,6 +290,20 @@ int lcd_create_char(uint8_t location, const uint8_t pattern[8])
         return LCD_ERR_PARAM;
     }
 
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    // Skip patterns that are already loaded
+    if ((lcd_cgram_loaded & (1U << location)) && memcmp(lcd_cgram_shadow[location], pattern, LCD_CGRAM_ROWS) == 0)
+    {
+        return LCD_SUCCESS;
+    }
+
+    uint8_t saved_address = lcd_address;
+    bool saved_cgram = lcd_address_cgram;
+
     // Set CGRAM address
     lcd_write_byte(LCD_CMD_CGRAM_ADDR | (location << 3), true);
 
@@ -181,8 +313,12 @@ int lcd_create_char(uint8_t location, const uint8_t pattern[8])
         lcd_write_byte(pattern[i], false);
     }
 
-    // Return to DDRAM mode
-    lcd_write_byte(LCD_CMD_DDRAM_ADDR, true);
+    // Return to DDRAM mode at the previous cursor position
+    if (saved_cgram || saved_address > LCD_DDRAM_ADDR_MASK)
+    {
+        saved_address = 0;
+    }
+    lcd_write_byte(LCD_CMD_DDRAM_ADDR | saved_address, true);
     return LCD_SUCCESS;
 }
 
@@ -203,22 +339,200 @@ int lcd_set_display(const struct lcd_display_config *config)
         return LCD_ERR_PARAM;
     }
 
-    uint8_t display = LCD_CMD_DISPLAY_CTRL;
-    if (config->display_on)
+    if (lcd_init_state != LCD_INIT_DONE)
     {
-        display |= LCD_DISPLAY_ON;
+        return LCD_ERR_BUSY;
     }
-    if (config->cursor_on)
+
+    lcd_write_byte(lcd_display_ctrl_cmd(config), true);
+    current_config.display = *config;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Replaces the timing configuration
+ *
+ * @param timing Pointer to the timing configuration structure
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_set_timing(const struct lcd_timing_config *timing)
+{
+    if (timing == NULL)
     {
-        display |= LCD_CURSOR_ON;
+        return LCD_ERR_PARAM;
     }
-    if (config->cursor_blink)
+
+    current_config.timing = *timing;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Configures how the driver waits
+ *
+ * @param config Pointer to the power configuration structure
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_set_power_mode(const struct lcd_power_config *config)
+{
+    if (config == NULL)
     {
-        display |= LCD_BLINK_ON;
+        return LCD_ERR_PARAM;
     }
 
-    lcd_write_byte(display, true);
-    current_config.display = *config;
+    lcd_power = *config;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Reports the time spent waiting
+ *
+ * @param stats Pointer receiving the statistics
+ * @param reset Clear the statistics after reading them
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_get_power_stats(struct lcd_power_stats *stats, bool reset)
+{
+    if (stats == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    *stats = lcd_power_stats;
+    if (reset)
+    {
+        lcd_power_stats = (struct lcd_power_stats){0};
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Measures the execution times of the connected panel
+ *
+ * This function issues a harmless instance of every instruction class,
+ * plus a data write and read, and polls the busy flag until it clears.
+ * The shortest of LCD_AUTOTUNE_SAMPLES runs is kept, since interrupts and
+ * polling can only lengthen a measurement, and the margin is added on top.
+ * Data accesses also get the address update time the busy flag does not
+ * cover. A class finishing faster than a fraction of its datasheet time
+ * means the busy flag is not read back, and nothing is returned.
+ * The clear instruction blanks the display, so the contents and the cursor
+ * are restored from the shadow at the end.
+ *
+ * @param margin_percent Safety margin added to the measured times
+ * @param timing Pointer receiving the derived timing configuration
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters,
+ *         LCD_ERR_BUSY if LCD is busy, did not respond or the busy flag is implausible,
+ *         LCD_ERR_UNSUPPORTED without RW pin
+ */
+int lcd_autotune(uint8_t margin_percent, struct lcd_timing_config *timing)
+{
+    if (timing == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    if (current_config.pins.rw.port == NULL)
+    {
+        return LCD_ERR_UNSUPPORTED;
+    }
+
+    uint8_t saved_shadow[LCD_ROWS][LCD_COLUMNS];
+    uint8_t saved_address = lcd_address;
+    bool saved_cgram = lcd_address_cgram;
+    memcpy(saved_shadow, lcd_shadow, sizeof(lcd_shadow));
+
+    const uint8_t probes[LCD_EXEC_DATA_WRITE] = {
+        [LCD_EXEC_CLEAR] = LCD_CMD_CLEAR,
+        [LCD_EXEC_HOME] = LCD_CMD_HOME,
+        [LCD_EXEC_ENTRY_MODE] = LCD_CMD_ENTRY_MODE | LCD_ENTRY_INCREMENT,
+        [LCD_EXEC_DISPLAY_CTRL] = lcd_display_ctrl_cmd(&current_config.display),
+        [LCD_EXEC_SHIFT] = LCD_CMD_SHIFT | LCD_SHIFT_RIGHT,
+        [LCD_EXEC_FUNCTION_SET] = lcd_function_set_cmd(&current_config.display),
+        [LCD_EXEC_CGRAM_ADDR] = LCD_CMD_CGRAM_ADDR,
+        [LCD_EXEC_DDRAM_ADDR] = LCD_CMD_DDRAM_ADDR,
+    };
+    uint32_t measured[LCD_EXEC_COUNT];
+    bool timed_out = false;
+
+    for (int cls = 0; cls < LCD_EXEC_COUNT; cls++)
+    {
+        measured[cls] = UINT32_MAX;
+        for (int n = 0; n < LCD_AUTOTUNE_SAMPLES; n++)
+        {
+            if (cls < LCD_EXEC_DATA_WRITE)
+            {
+                lcd_send_byte(probes[cls], true);
+            }
+            else
+            {
+                lcd_write_byte(LCD_CMD_DDRAM_ADDR | LCD_ROW_OFFSET_0, true);
+                if (cls == LCD_EXEC_DATA_WRITE)
+                {
+                    lcd_send_byte(lcd_shadow[0][0], false);
+                }
+                else
+                {
+                    lcd_receive_byte(false);
+                }
+            }
+
+            uint32_t elapsed = lcd_wait_busy_us();
+            if (elapsed >= LCD_AUTOTUNE_TIMEOUT_US)
+            {
+                timed_out = true;
+            }
+            if (elapsed < measured[cls])
+            {
+                measured[cls] = elapsed;
+            }
+        }
+    }
+
+    /* The shift probe moved the cursor behind the mirror's back */
+    lcd_address = 0xFF;
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        lcd_update_row(row, 0, saved_shadow[row], LCD_COLUMNS);
+    }
+    if (saved_address > LCD_DDRAM_ADDR_MASK)
+    {
+        saved_address = 0;
+        saved_cgram = false;
+    }
+    lcd_address = 0xFF;
+    lcd_set_address(saved_address, saved_cgram);
+
+    if (timed_out)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    for (int cls = 0; cls < LCD_EXEC_COUNT; cls++)
+    {
+        /* Datasheet execution times at 270 kHz */
+        uint32_t datasheet_us = cls <= LCD_EXEC_HOME ? 1520U : 37U;
+        if (measured[cls] < datasheet_us / LCD_AUTOTUNE_MIN_DIVISOR)
+        {
+            return LCD_ERR_BUSY;
+        }
+    }
+
+    *timing = current_config.timing;
+    for (int cls = 0; cls < LCD_EXEC_COUNT; cls++)
+    {
+        uint32_t us = measured[cls];
+        if (cls >= LCD_EXEC_DATA_WRITE)
+        {
+            us += LCD_ADDRESS_UPDATE_US;
+        }
+        us = us * (100U + margin_percent) / 100U + 1U;
+        timing->exec_us[cls] = us > UINT16_MAX ? UINT16_MAX : (uint16_t)us;
+    }
     return LCD_SUCCESS;
 }
 
@@ -232,8 +546,12 @@ int lcd_set_display(const struct lcd_display_config *config)
  */
 int lcd_clear(void)
 {
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
     lcd_write_byte(LCD_CMD_CLEAR, true);
-    lcd_delay_us(current_config.timing.clear_delay_us);
     return LCD_SUCCESS;
 }
 
@@ -248,6 +566,11 @@ int lcd_clear(void)
  */
 int lcd_write_char(char c)
 {
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
     lcd_write_byte((uint8_t)c, false);
     return LCD_SUCCESS;
 }
@@ -255,7 +578,7 @@ int lcd_write_char(char c)
 /**
  * @brief Writes a string to the LCD
  *
- * This function writes a string to the LCD, character by character.
+ * This function writes a string to the LCD as a single data run.
  *
  * @param str Pointer to the string to be written
  * @return LCD_SUCCESS if the operation was successful, LCD_ERR_PARAM if the string is NULL
@@ -267,96 +590,1011 @@ int lcd_write_string(const char *str)
         return LCD_ERR_PARAM;
     }
 
-    while (*str)
+    if (lcd_init_state != LCD_INIT_DONE)
     {
-        lcd_write_char(*str++);
+        return LCD_ERR_BUSY;
+    }
+
+    /* The address is not known here and may even be in CGRAM, so the
+     * mirror follows the run byte by byte */
+    size_t len = strlen(str);
+    lcd_write_data((const uint8_t *)str, len);
+    for (size_t i = 0; i < len; i++)
+    {
+        lcd_track_byte((uint8_t)str[i], false);
     }
     return LCD_SUCCESS;
 }
 
-/* Private functions */
-
 /**
- * @brief Writes a single bit to a GPIO pin
+ * @brief Writes a buffer to the LCD starting at a position
  *
- * This function writes a specific state (SET or RESET) to a GPIO pin
- * for controlling the LCD.
+ * This function writes the characters as one data run per row, wrapping
+ * from the end of a row to the start of the next one (and from the last
+ * row to the first).
  *
- * @param gpio Pointer to the GPIO configuration structure
- * @param state State to write to the pin (GPIO_PIN_SET or GPIO_PIN_RESET)
+ * @param row Row position (0 or 1)
+ * @param column Column position (0 to 15)
+ * @param buf Character codes to write
+ * @param len Number of characters, at most one screenful
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters, LCD_ERR_BUSY if LCD is busy
  */
-static void lcd_gpio_write(const struct lcd_gpio_config *gpio, GPIO_PinState state)
+int lcd_write_buffer(uint8_t row, uint8_t column, const uint8_t *buf, size_t len)
 {
-    HAL_GPIO_WritePin(gpio->port, gpio->pin, state);
+    if (row >= LCD_ROWS || column >= LCD_COLUMNS || buf == NULL || len > LCD_ROWS * LCD_COLUMNS)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    while (len > 0)
+    {
+        size_t run = LCD_COLUMNS - column;
+        if (run > len)
+        {
+            run = len;
+        }
+
+        lcd_write_row(row, column, buf, run);
+
+        buf += run;
+        len -= run;
+        row = (row + 1) % LCD_ROWS;
+        column = 0;
+    }
+    return LCD_SUCCESS;
 }
 
 /**
- * @brief Sends a 4-bit nibble to the LCD
+ * @brief Writes a rectangular block of characters to the LCD
  *
- * This function sends a 4-bit data nibble to the LCD display by setting
- * the appropriate GPIO pins and pulsing the enable pin.
+ * This function copies a row-major block of characters to the display,
+ * sending each block row as one data run.
  *
- * @param data 4-bit data to be sent to the LCD
+ * @param row Top row position
+ * @param column Left column position
+ * @param height Number of rows in the block
+ * @param width Number of columns in the block
+ * @param buf Character codes, height * width bytes row-major
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters, LCD_ERR_BUSY if LCD is busy
  */
-static void lcd_write_4bits(uint8_t data)
+int lcd_write_region(uint8_t row, uint8_t column, uint8_t height, uint8_t width, const uint8_t *buf)
 {
-    for (int i = 0; i < 4; i++)
+    if (row >= LCD_ROWS || column >= LCD_COLUMNS || buf == NULL ||
+        height > LCD_ROWS - row || width > LCD_COLUMNS - column)
     {
-        lcd_gpio_write(&current_config.pins.data[i], (data >> i) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
+        return LCD_ERR_PARAM;
     }
-    lcd_pulse_enable();
+
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    for (uint8_t i = 0; i < height; i++)
+    {
+        lcd_write_row(row + i, column, &buf[i * width], width);
+    }
+    return LCD_SUCCESS;
 }
 
 /**
- * @brief Sends a byte to the LCD
+ * @brief Updates part of a row, writing only changed characters
  *
- * This function sends a full byte (high and low nibbles) to the LCD.
- * It distinguishes between commands and data by using the RS pin.
+ * This function diffs the given characters against the display shadow and
+ * sends only the ones that differ. Runs of changed characters share a single
+ * address set since the address counter advances on every write.
  *
- * @param data Byte to be sent to the LCD
- * @param is_cmd Flag indicating whether the byte is a command (true) or data (false)
+ * @param row Row position (0 or 1)
+ * @param column Column of the first character
+ * @param cells Character codes to show
+ * @param len Number of characters
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters, LCD_ERR_BUSY if LCD is busy
  */
-static void lcd_write_byte(uint8_t data, bool is_cmd)
+int lcd_update_row(uint8_t row, uint8_t column, const uint8_t *cells, uint8_t len)
 {
-    lcd_gpio_write(&current_config.pins.rs, is_cmd ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    if (row >= LCD_ROWS || column >= LCD_COLUMNS || cells == NULL || len > LCD_COLUMNS - column)
+    {
+        return LCD_ERR_PARAM;
+    }
 
-    /* Send high nibble */
-    lcd_write_4bits(data >> 4);
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
 
-    /* Send low nibble */
-    lcd_write_4bits(data & 0x0F);
+    uint8_t i = 0;
+    while (i < len)
+    {
+        if (cells[i] == lcd_shadow[row][column + i])
+        {
+            i++;
+            continue;
+        }
 
-    lcd_delay_us(current_config.timing.cmd_delay_us);
+        /* Send the run of changed cells starting here in one go */
+        uint8_t start = i;
+        while (i < len && cells[i] != lcd_shadow[row][column + i])
+        {
+            i++;
+        }
+        lcd_write_row(row, column + start, &cells[start], i - start);
+    }
+    return LCD_SUCCESS;
 }
 
 /**
- * @brief Pulses the enable pin to latch the data
+ * @brief Reads a cell from the display shadow
  *
- * This function pulses the enable pin to latch data sent to the LCD
- * by toggling the enable pin state.
+ * This function returns the character code the driver last wrote to the
+ * given position, without accessing the LCD.
+ *
+ * @param row Row position (0 or 1)
+ * @param column Column position (0 to 15)
+ * @param c Pointer receiving the character code
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
  */
-static void lcd_pulse_enable(void)
+int lcd_get_char(uint8_t row, uint8_t column, uint8_t *c)
 {
-    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_RESET);
-    lcd_delay_us(1);
-    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_SET);
-    lcd_delay_us(current_config.timing.enable_pulse_us);
-    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_RESET);
+    if (row >= LCD_ROWS || column >= LCD_COLUMNS || c == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    *c = lcd_shadow[row][column];
+    return LCD_SUCCESS;
 }
 
 /**
- * @brief Delays for a specified number of microseconds
+ * @brief Registers a holder of CGRAM character codes
+ *
+ * @param holder Callback returning a bit mask of referenced locations
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters or the table is full
+ */
+int lcd_cgram_add_holder(uint8_t (*holder)(void))
+{
+    if (holder == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    for (int i = 0; i < LCD_CGRAM_HOLDERS; i++)
+    {
+        if (lcd_cgram_holders[i] == holder)
+        {
+            return LCD_SUCCESS;
+        }
+        if (lcd_cgram_holders[i] == NULL)
+        {
+            lcd_cgram_holders[i] = holder;
+            return LCD_SUCCESS;
+        }
+    }
+    return LCD_ERR_PARAM;
+}
+
+/**
+ * @brief Collects the CGRAM locations in use
+ *
+ * This function combines the locations referenced by the display shadow
+ * with those reported by the registered holders.
+ *
+ * @return Bit mask of referenced locations
+ */
+uint8_t lcd_cgram_in_use(void)
+{
+    uint8_t used = lcd_cgram_refs(&lcd_shadow[0][0], sizeof(lcd_shadow));
+
+    for (int i = 0; i < LCD_CGRAM_HOLDERS && lcd_cgram_holders[i] != NULL; i++)
+    {
+        used |= lcd_cgram_holders[i]();
+    }
+    return used;
+}
+
+/**
+ * @brief Collects the CGRAM locations referenced by a buffer
+ *
+ * @param cells Character codes
+ * @param len Number of character codes
+ * @return Bit mask of referenced locations
+ */
+uint8_t lcd_cgram_refs(const uint8_t *cells, size_t len)
+{
+    uint8_t used = 0;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        /* 0x08-0x0F address the same patterns as 0x00-0x07 */
+        if (cells[i] < 2 * LCD_CGRAM_CHARS)
+        {
+            used |= 1U << (cells[i] % LCD_CGRAM_CHARS);
+        }
+    }
+    return used;
+}
+
+/**
+ * @brief Scrubs the next row of the display against the shadow copy
+ *
+ * Steps 0 to LCD_ROWS - 1 handle the DDRAM rows, the last step handles the
+ * loaded CGRAM patterns. With an RW pin the controller memory is read back
+ * and only mismatching bytes are rewritten, otherwise everything in the step
+ * is rewritten from the shadow. The address counter is restored afterwards,
+ * so the call can be interleaved with regular writes.
+ *
+ * @return LCD_SUCCESS on successful execution
+ */
+int lcd_scrub_step(void)
+{
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    uint8_t saved_address = lcd_address;
+    bool saved_cgram = lcd_address_cgram;
+    bool readback = current_config.pins.rw.port != NULL;
+
+    if (lcd_scrub_index < LCD_ROWS)
+    {
+        uint8_t row = lcd_scrub_index;
+        uint8_t base = lcd_row_offsets[row];
+        uint8_t actual[LCD_COLUMNS];
+
+        if (readback)
+        {
+            /* Reads are only valid after an address set, even a redundant one */
+            lcd_write_byte(LCD_CMD_DDRAM_ADDR | base, true);
+            for (int col = 0; col < LCD_COLUMNS; col++)
+            {
+                actual[col] = lcd_read_byte(false);
+            }
+        }
+
+        for (int col = 0; col < LCD_COLUMNS; col++)
+        {
+            if (readback && actual[col] == lcd_shadow[row][col])
+            {
+                continue;
+            }
+            lcd_set_address(base + col, false);
+            lcd_write_byte(lcd_shadow[row][col], false);
+        }
+    }
+    else
+    {
+        for (int loc = 0; loc < LCD_CGRAM_CHARS; loc++)
+        {
+            if (!(lcd_cgram_loaded & (1U << loc)))
+            {
+                continue;
+            }
+
+            uint8_t base = loc * LCD_CGRAM_ROWS;
+            uint8_t actual[LCD_CGRAM_ROWS];
+
+            if (readback)
+            {
+                lcd_write_byte(LCD_CMD_CGRAM_ADDR | base, true);
+                for (int i = 0; i < LCD_CGRAM_ROWS; i++)
+                {
+                    actual[i] = lcd_read_byte(false);
+                }
+            }
+
+            for (int i = 0; i < LCD_CGRAM_ROWS; i++)
+            {
+                /* Only the low 5 bits of a pattern row are stored */
+                if (readback && ((actual[i] ^ lcd_cgram_shadow[loc][i]) & 0x1F) == 0)
+                {
+                    continue;
+                }
+                lcd_set_address(base + i, true);
+                lcd_write_byte(lcd_cgram_shadow[loc][i], false);
+            }
+        }
+    }
+
+    lcd_set_address(saved_address, saved_cgram);
+    lcd_scrub_index = (lcd_scrub_index + 1) % (LCD_ROWS + 1);
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Resynchronizes the controller after interface corruption
+ *
+ * This function realigns the 4-bit interface, re-issues function set,
+ * entry mode and display control and reloads the CGRAM patterns from the
+ * shadow copy. Unlike lcd_init() it skips the power-on delays and does not
+ * clear the display.
+ *
+ * @return LCD_SUCCESS on successful execution
+ */
+int lcd_resync(void)
+{
+    uint8_t saved_address = lcd_address;
+    bool saved_cgram = lcd_address_cgram;
+
+    if (lcd_init_state != LCD_INIT_DONE)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    lcd_realign_interface();
+
+    lcd_write_byte(lcd_function_set_cmd(&current_config.display), true);
+    lcd_write_byte(LCD_CMD_ENTRY_MODE | LCD_ENTRY_INCREMENT, true);
+    lcd_write_byte(lcd_display_ctrl_cmd(&current_config.display), true);
+
+    for (int loc = 0; loc < LCD_CGRAM_CHARS; loc++)
+    {
+        if (lcd_cgram_loaded & (1U << loc))
+        {
+            lcd_write_byte(LCD_CMD_CGRAM_ADDR | (loc << 3), true);
+            for (int i = 0; i < LCD_CGRAM_ROWS; i++)
+            {
+                lcd_write_byte(lcd_cgram_shadow[loc][i], false);
+            }
+        }
+    }
+
+    /* The address counter is unknown after realignment, always reload it */
+    lcd_write_byte((saved_cgram ? LCD_CMD_CGRAM_ADDR : LCD_CMD_DDRAM_ADDR) | saved_address, true);
+    lcd_scrub_index = 0;
+    return LCD_SUCCESS;
+}
+
+/* Private functions */
+
+/**
+ * @brief Stores the configuration and prepares GPIO and shadow state
+ *
+ * The initialization state is left idle; callers enter the power-on
+ * sequence only once its wait is armed, so a concurrent lcd_init_poll()
+ * cannot start it early.
+ *
+ * @param config Pointer to the configuration structure
+ */
+static void lcd_init_hw(const struct lcd_config *config)
+{
+    lcd_init_state = LCD_INIT_IDLE;
+
+    /* Store configuration */
+    current_config = *config;
+
+    /* Configure GPIO pins */
+    GPIO_InitTypeDef gpio_init = {0};
+    gpio_init.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio_init.Pull = GPIO_NOPULL;
+    gpio_init.Speed = GPIO_SPEED_FREQ_LOW;
+
+    /* Initialize RS pin */
+    gpio_init.Pin = config->pins.rs.pin;
+    HAL_GPIO_Init(config->pins.rs.port, &gpio_init);
+
+    /* Initialize EN pin */
+    gpio_init.Pin = config->pins.en.pin;
+    HAL_GPIO_Init(config->pins.en.port, &gpio_init);
+
+    /* Initialize RW pin (optional), held low for writes */
+    if (config->pins.rw.port != NULL)
+    {
+        gpio_init.Pin = config->pins.rw.pin;
+        HAL_GPIO_Init(config->pins.rw.port, &gpio_init);
+        lcd_gpio_write(&config->pins.rw, GPIO_PIN_RESET);
+    }
+
+    /* Initialize Data pins */
+    lcd_set_data_direction(GPIO_MODE_OUTPUT_PP);
+
+    /* Reset shadow state, the address counter is unknown until the first address set */
+    memset(lcd_shadow, ' ', sizeof(lcd_shadow));
+    lcd_cgram_loaded = 0;
+    lcd_scrub_index = 0;
+    lcd_address = 0xFF;
+    lcd_address_cgram = false;
+}
+
+/**
+ * @brief Runs the next step of the power-on sequence
+ *
+ * @return Time in microseconds to wait before the following step
+ */
+static uint32_t lcd_init_step(void)
+{
+    switch (lcd_init_state)
+    {
+    case LCD_INIT_POWER_UP:
+        lcd_write_4bits(0x03);
+        lcd_init_state = LCD_INIT_WAKE_1;
+        return 4500;
+    case LCD_INIT_WAKE_1:
+        lcd_write_4bits(0x03);
+        lcd_init_state = LCD_INIT_WAKE_2;
+        return 4500;
+    case LCD_INIT_WAKE_2:
+        lcd_write_4bits(0x03);
+        lcd_init_state = LCD_INIT_WAKE_3;
+        return 150;
+    case LCD_INIT_WAKE_3:
+        /* Switch to 4-bit mode and configure */
+        lcd_write_4bits(0x02);
+        lcd_write_byte(lcd_function_set_cmd(&current_config.display), true);
+        lcd_write_byte(lcd_display_ctrl_cmd(&current_config.display), true);
+        lcd_send_byte(LCD_CMD_CLEAR, true);
+        lcd_init_state = LCD_INIT_CLEAR;
+        return current_config.timing.exec_us[LCD_EXEC_CLEAR];
+    case LCD_INIT_CLEAR:
+        lcd_init_state = LCD_INIT_DONE;
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Arms the HAL tick based wait of a non-blocking initialization
+ *
+ * One tick is added because the current tick period may be partly elapsed.
+ *
+ * @param us Minimum time to wait in microseconds
+ */
+static void lcd_init_wait(uint32_t us)
+{
+    lcd_init_tick = HAL_GetTick();
+    lcd_init_wait_ms = (us + 999U) / 1000U + 1U;
+}
+
+/**
+ * @brief Realigns the 4-bit interface of a running controller
+ *
+ * The 0x3, 0x3, 0x3, 0x2 nibble sequence puts the controller back into
+ * 4-bit mode regardless of the nibble phase it is in, without the
+ * power-on delays.
+ */
+static void lcd_realign_interface(void)
+{
+    lcd_gpio_write(&current_config.pins.rs, GPIO_PIN_RESET);
+
+    /* The first nibble may complete a stray half byte into any instruction,
+     * allow for the slowest before the datasheet's shorter second wait */
+    lcd_write_4bits(0x03);
+    lcd_delay_us(current_config.timing.exec_us[LCD_EXEC_CLEAR]);
+    lcd_write_4bits(0x03);
+    lcd_delay_us(150);
+    lcd_write_4bits(0x03);
+    lcd_delay_us(current_config.timing.exec_us[LCD_EXEC_FUNCTION_SET]);
+    lcd_write_4bits(0x02);
+    lcd_delay_us(current_config.timing.exec_us[LCD_EXEC_FUNCTION_SET]);
+}
+
+/**
+ * @brief Writes a single bit to a GPIO pin
+ *
+ * This function writes a specific state (SET or RESET) to a GPIO pin
+ * for controlling the LCD.
+ *
+ * @param gpio Pointer to the GPIO configuration structure
+ * @param state State to write to the pin (GPIO_PIN_SET or GPIO_PIN_RESET)
+ */
+static void lcd_gpio_write(const struct lcd_gpio_config *gpio, GPIO_PinState state)
+{
+    HAL_GPIO_WritePin(gpio->port, gpio->pin, state);
+}
+
+/**
+ * @brief Sends a 4-bit nibble to the LCD
+ *
+ * This function sends a 4-bit data nibble to the LCD display by setting
+ * the appropriate GPIO pins and pulsing the enable pin.
+ *
+ * @param data 4-bit data to be sent to the LCD
+ */
+static void lcd_write_4bits(uint8_t data)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        lcd_gpio_write(&current_config.pins.data[i], (data >> i) & 0x01 ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+    lcd_pulse_enable();
+}
+
+/**
+ * @brief Reads a 4-bit nibble from the LCD
+ *
+ * This function raises the enable pin, samples the data pins and lowers
+ * the enable pin again. The data pins must be configured as inputs.
+ *
+ * @return 4-bit data read from the LCD
+ */
+static uint8_t lcd_read_4bits(void)
+{
+    uint8_t data = 0;
+
+    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_SET);
+    lcd_delay_us(current_config.timing.enable_pulse_us);
+    for (int i = 0; i < 4; i++)
+    {
+        if (HAL_GPIO_ReadPin(current_config.pins.data[i].port, current_config.pins.data[i].pin) == GPIO_PIN_SET)
+        {
+            data |= 1U << i;
+        }
+    }
+    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_RESET);
+    lcd_delay_us(1);
+    return data;
+}
+
+/**
+ * @brief Reads a byte from the LCD and waits for the read to complete
+ *
+ * @param is_cmd Flag indicating whether to read the busy flag/address (true) or data (false)
+ * @return Byte read from the LCD
+ */
+static uint8_t lcd_read_byte(bool is_cmd)
+{
+    uint8_t data = lcd_receive_byte(is_cmd);
+    if (!is_cmd)
+    {
+        lcd_delay_us(current_config.timing.exec_us[LCD_EXEC_DATA_READ]);
+    }
+    return data;
+}
+
+/**
+ * @brief Reads a byte from the LCD without waiting
+ *
+ * This function switches the data pins to inputs, reads the high and low
+ * nibbles with RW asserted and restores the pins for writing. Requires the
+ * RW pin to be configured.
+ *
+ * @param is_cmd Flag indicating whether to read the busy flag/address (true) or data (false)
+ * @return Byte read from the LCD
+ */
+static uint8_t lcd_receive_byte(bool is_cmd)
+{
+    lcd_set_data_direction(GPIO_MODE_INPUT);
+    lcd_gpio_write(&current_config.pins.rs, is_cmd ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    lcd_gpio_write(&current_config.pins.rw, GPIO_PIN_SET);
+
+    uint8_t data = lcd_read_4bits() << 4;
+    data |= lcd_read_4bits();
+
+    lcd_gpio_write(&current_config.pins.rw, GPIO_PIN_RESET);
+    lcd_set_data_direction(GPIO_MODE_OUTPUT_PP);
+
+    if (!is_cmd)
+    {
+        /* Data reads advance the address counter like writes do */
+        if (lcd_address_cgram)
+        {
+            lcd_address = (lcd_address + 1) & LCD_CGRAM_ADDR_MASK;
+        }
+        else
+        {
+            lcd_address = lcd_next_ddram_address(lcd_address);
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Returns a microsecond timestamp
+ *
+ * Combines the HAL tick with the SysTick counter, assuming the default
+ * 1 kHz HAL tick.
+ *
+ * @return Time in microseconds, wrapping at 2^32
+ */
+static uint32_t lcd_time_us(void)
+{
+    uint32_t tick;
+    uint32_t val;
+
+    do
+    {
+        tick = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (tick != HAL_GetTick());
+
+    uint32_t load = SysTick->LOAD + 1U;
+    return tick * 1000U + (load - 1U - val) * 1000U / load;
+}
+
+/**
+ * @brief Polls the busy flag until it clears
+ *
+ * The data pins stay configured as inputs for the whole poll. Gives up
+ * after LCD_AUTOTUNE_TIMEOUT_US.
+ *
+ * @return Time in microseconds until the busy flag cleared
+ */
+static uint32_t lcd_wait_busy_us(void)
+{
+    uint32_t start = lcd_time_us();
+    int32_t elapsed;
+    bool busy;
+
+    lcd_set_data_direction(GPIO_MODE_INPUT);
+    lcd_gpio_write(&current_config.pins.rs, GPIO_PIN_RESET);
+    lcd_gpio_write(&current_config.pins.rw, GPIO_PIN_SET);
+    do
+    {
+        busy = ((lcd_read_4bits() << 4) & LCD_BUSY_FLAG) != 0;
+        lcd_read_4bits();
+
+        /* A tick update racing the timestamp can make it step back */
+        elapsed = (int32_t)(lcd_time_us() - start);
+        if (elapsed < 0)
+        {
+            elapsed = 0;
+        }
+    } while (busy && elapsed < LCD_AUTOTUNE_TIMEOUT_US);
+    lcd_gpio_write(&current_config.pins.rw, GPIO_PIN_RESET);
+    lcd_set_data_direction(GPIO_MODE_OUTPUT_PP);
+
+    return (uint32_t)elapsed;
+}
+
+/**
+ * @brief Configures the direction of the data pins
+ *
+ * @param mode GPIO_MODE_OUTPUT_PP for writing, GPIO_MODE_INPUT for reading
+ */
+static void lcd_set_data_direction(uint32_t mode)
+{
+    GPIO_InitTypeDef gpio_init = {0};
+    gpio_init.Mode = mode;
+    gpio_init.Pull = GPIO_NOPULL;
+    gpio_init.Speed = GPIO_SPEED_FREQ_LOW;
+
+    for (int i = 0; i < 4; i++)
+    {
+        gpio_init.Pin = current_config.pins.data[i].pin;
+        HAL_GPIO_Init(current_config.pins.data[i].port, &gpio_init);
+    }
+}
+
+/**
+ * @brief Returns the DDRAM address following the given one
+ *
+ * @param address Current DDRAM address
+ * @return Address the controller moves to after a data access
+ */
+static uint8_t lcd_next_ddram_address(uint8_t address)
+{
+    address++;
+    if (!current_config.display.two_lines)
+    {
+        return address % LCD_DDRAM_SIZE;
+    }
+    if (address == LCD_ROW_OFFSET_0 + LCD_DDRAM_LINE_SIZE)
+    {
+        return LCD_ROW_OFFSET_1;
+    }
+    if (address == LCD_ROW_OFFSET_1 + LCD_DDRAM_LINE_SIZE)
+    {
+        return LCD_ROW_OFFSET_0;
+    }
+    return address;
+}
+
+/**
+ * @brief Mirrors a transferred byte into the shadow state
+ *
+ * Keeps the address counter mirror and the DDRAM/CGRAM shadow copies in
+ * sync with what the controller does for the given byte.
+ *
+ * @param data Byte sent to the LCD
+ * @param is_cmd Flag indicating whether the byte is a command (true) or data (false)
+ */
+static void lcd_track_byte(uint8_t data, bool is_cmd)
+{
+    if (!is_cmd)
+    {
+        if (lcd_address_cgram)
+        {
+            uint8_t loc = lcd_address / LCD_CGRAM_ROWS;
+            lcd_cgram_shadow[loc][lcd_address % LCD_CGRAM_ROWS] = data;
+            lcd_cgram_loaded |= 1U << loc;
+            lcd_address = (lcd_address + 1) & LCD_CGRAM_ADDR_MASK;
+            return;
+        }
+
+        for (int row = 0; row < LCD_ROWS; row++)
+        {
+            if (lcd_address >= lcd_row_offsets[row] && lcd_address < lcd_row_offsets[row] + LCD_COLUMNS)
+            {
+                lcd_shadow[row][lcd_address - lcd_row_offsets[row]] = data;
+                break;
+            }
+        }
+        lcd_address = lcd_next_ddram_address(lcd_address);
+        return;
+    }
+
+    if (data & LCD_CMD_DDRAM_ADDR)
+    {
+        lcd_address = data & LCD_DDRAM_ADDR_MASK;
+        lcd_address_cgram = false;
+    }
+    else if (data & LCD_CMD_CGRAM_ADDR)
+    {
+        lcd_address = data & LCD_CGRAM_ADDR_MASK;
+        lcd_address_cgram = true;
+    }
+    else if (data == LCD_CMD_CLEAR)
+    {
+        memset(lcd_shadow, ' ', sizeof(lcd_shadow));
+        lcd_address = 0;
+        lcd_address_cgram = false;
+    }
+    else if ((data & ~0x01) == LCD_CMD_HOME)
+    {
+        lcd_address = 0;
+        lcd_address_cgram = false;
+    }
+}
+
+/**
+ * @brief Moves the address counter unless it is already there
+ *
+ * @param address DDRAM or CGRAM address
+ * @param cgram Flag indicating whether the address is in CGRAM (true) or DDRAM (false)
+ */
+static void lcd_set_address(uint8_t address, bool cgram)
+{
+    if (address == lcd_address && cgram == lcd_address_cgram)
+    {
+        return;
+    }
+    lcd_write_byte((cgram ? LCD_CMD_CGRAM_ADDR : LCD_CMD_DDRAM_ADDR) | address, true);
+}
+
+/**
+ * @brief Builds the function set instruction for a display configuration
+ *
+ * @param config Pointer to the display configuration structure
+ * @return Function set instruction byte
+ */
+static uint8_t lcd_function_set_cmd(const struct lcd_display_config *config)
+{
+    uint8_t function = LCD_CMD_FUNCTION_SET;
+    if (config->two_lines)
+    {
+        function |= LCD_TWO_LINE;
+    }
+    if (config->big_font)
+    {
+        function |= LCD_5x10_DOTS;
+    }
+    return function;
+}
+
+/**
+ * @brief Builds the display control instruction for a display configuration
+ *
+ * @param config Pointer to the display configuration structure
+ * @return Display control instruction byte
+ */
+static uint8_t lcd_display_ctrl_cmd(const struct lcd_display_config *config)
+{
+    uint8_t display = LCD_CMD_DISPLAY_CTRL;
+    if (config->display_on)
+    {
+        display |= LCD_DISPLAY_ON;
+    }
+    if (config->cursor_on)
+    {
+        display |= LCD_CURSOR_ON;
+    }
+    if (config->cursor_blink)
+    {
+        display |= LCD_BLINK_ON;
+    }
+    return display;
+}
+
+/**
+ * @brief Sends a byte to the LCD and waits for it to execute
+ *
+ * The wait is taken from the timing table entry of the instruction class,
+ * or of data writes.
+ *
+ * @param data Byte to be sent to the LCD
+ * @param is_cmd Flag indicating whether the byte is a command (true) or data (false)
+ */
+static void lcd_write_byte(uint8_t data, bool is_cmd)
+{
+    lcd_send_byte(data, is_cmd);
+    lcd_delay_us(current_config.timing.exec_us[is_cmd ? lcd_exec_class(data) : LCD_EXEC_DATA_WRITE]);
+}
+
+/**
+ * @brief Writes a run of data bytes to the LCD
+ *
+ * RS is latched once for the whole run and the data write time is looked
+ * up once, leaving only the nibble transfers and the wait per byte. The
+ * shadow and address mirror are left to the caller.
+ *
+ * @param buf Data bytes to write
+ * @param len Number of bytes
+ */
+static void lcd_write_data(const uint8_t *buf, size_t len)
+{
+    uint32_t exec_us = current_config.timing.exec_us[LCD_EXEC_DATA_WRITE];
+
+    lcd_gpio_write(&current_config.pins.rs, GPIO_PIN_SET);
+    for (size_t i = 0; i < len; i++)
+    {
+        lcd_write_4bits(buf[i] >> 4);
+        lcd_write_4bits(buf[i] & 0x0F);
+        lcd_delay_us(exec_us);
+    }
+}
+
+/**
+ * @brief Writes a run of characters within one display row
+ *
+ * Since the run never leaves the row, the shadow is updated with a single
+ * copy and the address mirror advanced by the run length.
+ *
+ * @param row Row position
+ * @param column Column of the first character
+ * @param buf Character codes to write
+ * @param len Number of characters, at most LCD_COLUMNS - column
+ */
+static void lcd_write_row(uint8_t row, uint8_t column, const uint8_t *buf, size_t len)
+{
+    lcd_set_address(lcd_row_offsets[row] + column, false);
+    lcd_write_data(buf, len);
+    memcpy(&lcd_shadow[row][column], buf, len);
+    lcd_address += len;
+}
+
+/**
+ * @brief Sends a byte to the LCD without waiting
+ *
+ * This function sends a full byte (high and low nibbles) to the LCD.
+ * It distinguishes between commands and data by using the RS pin.
+ *
+ * @param data Byte to be sent to the LCD
+ * @param is_cmd Flag indicating whether the byte is a command (true) or data (false)
+ */
+static void lcd_send_byte(uint8_t data, bool is_cmd)
+{
+    lcd_gpio_write(&current_config.pins.rs, is_cmd ? GPIO_PIN_RESET : GPIO_PIN_SET);
+
+    /* Send high nibble */
+    lcd_write_4bits(data >> 4);
+
+    /* Send low nibble */
+    lcd_write_4bits(data & 0x0F);
+
+    lcd_track_byte(data, is_cmd);
+}
+
+/**
+ * @brief Returns the timing class of an instruction
+ *
+ * Instructions are identified by their highest set bit, which is also
+ * their index in the timing table.
+ *
+ * @param cmd Instruction byte
+ * @return Timing table index
+ */
+static enum lcd_exec lcd_exec_class(uint8_t cmd)
+{
+    uint8_t index = LCD_EXEC_DDRAM_ADDR;
+    while (index > 0 && !(cmd & (1U << index)))
+    {
+        index--;
+    }
+    return (enum lcd_exec)index;
+}
+
+/**
+ * @brief Pulses the enable pin to latch the data
+ *
+ * This function pulses the enable pin to latch data sent to the LCD
+ * by toggling the enable pin state.
+ */
+static void lcd_pulse_enable(void)
+{
+    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_RESET);
+    lcd_delay_us(1);
+    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_SET);
+    lcd_delay_us(current_config.timing.enable_pulse_us);
+    lcd_gpio_write(&current_config.pins.en, GPIO_PIN_RESET);
+}
+
+/**
+ * @brief Delays for a specified number of microseconds
  *
  * This function introduces a delay of a specified duration, in microseconds.
  *
  * @param us Number of microseconds to delay
  */
 static void lcd_delay_us(uint32_t us)
+{
+    if (lcd_power.sleep_on_wait && us >= lcd_power.sleep_threshold_us)
+    {
+        lcd_sleep_us(us);
+        return;
+    }
+
+    lcd_spin_us(us);
+}
+
+/**
+ * @brief Busy-waits for a specified number of microseconds
+ *
+ * Counts core cycles, so it needs no timer and works before any timebase
+ * is running or with interrupts masked.
+ *
+ * @param us Number of microseconds to delay
+ */
+static void lcd_spin_us(uint32_t us)
 {
     uint32_t count = (SystemCoreClock / 1000000U) * us / 5;
     while (count--)
     {
         __NOP();
     }
+    lcd_power_stats.spin_us += us;
+}
+
+/**
+ * @brief Waits for a specified number of microseconds in sleep mode
+ *
+ * The core executes WFI until the deadline, woken by the timer armed
+ * through the arm_wakeup hook or else by the SysTick interrupt. Whatever
+ * is left below the sleep threshold (or below one tick without a hook) is
+ * spun. Falls back to spinning when interrupts cannot wake the core, i.e.
+ * with interrupts masked or in handler mode, and when SysTick is not
+ * running to time the sleep (e.g. HAL timebase on a TIMx).
+ *
+ * @param us Number of microseconds to delay
+ */
+static void lcd_sleep_us(uint32_t us)
+{
+    if (__get_PRIMASK() != 0 || __get_IPSR() != 0 || !(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk))
+    {
+        lcd_spin_us(us);
+        return;
+    }
+
+    uint32_t start = lcd_time_us();
+    uint32_t elapsed = 0;
+
+    while (elapsed < us)
+    {
+        uint32_t remaining = us - elapsed;
+        if (remaining < lcd_power.sleep_threshold_us ||
+            (lcd_power.arm_wakeup == NULL && remaining < LCD_SYSTICK_PERIOD_US))
+        {
+            lcd_spin_us(remaining);
+            break;
+        }
+
+        if (lcd_power.arm_wakeup != NULL)
+        {
+            lcd_power.arm_wakeup(remaining);
+        }
+        __WFI();
+
+        uint32_t now = lcd_time_us() - start;
+        if ((int32_t)now > (int32_t)elapsed)
+        {
+            lcd_power_stats.sleep_us += now - elapsed;
+            elapsed = now;
+        }
+        lcd_power_stats.sleep_count++;
+    }
 }
 
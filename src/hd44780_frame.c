@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Double-buffered drawing for LCD 16x2 Display Driver
+ *
+ * This file provides a back buffer for the application and a present
+ * operation that snapshots it with interrupts masked. Snapshots wait in a
+ * single pending slot, so presents issued while a frame is still being
+ * transmitted coalesce into the latest one. The transmitter diffs against
+ * the display shadow through lcd_update_row() and restarts from the top
+ * whenever a newer frame arrives between rows.
+ */
+
+#include "hd44780_frame.h"
+#include <string.h>
+
+static struct lcd_frame frame_back;
+static struct lcd_frame frame_pending;
+static bool frame_back_ready;
+static volatile bool frame_pending_valid;
+static volatile bool frame_transmitting;
+
+/* Private function prototypes */
+static void lcd_frame_prepare(void);
+static bool lcd_frame_take(struct lcd_frame *frame);
+static uint8_t lcd_frame_cgram_refs(void);
+
+/**
+ * @brief Returns the back buffer
+ *
+ * @return Pointer to the back buffer
+ */
+struct lcd_frame *lcd_frame_back(void)
+{
+    lcd_frame_prepare();
+    return &frame_back;
+}
+
+/**
+ * @brief Fills the back buffer with spaces
+ */
+void lcd_frame_clear(void)
+{
+    memset(frame_back.cells, ' ', sizeof(frame_back.cells));
+    frame_back_ready = true;
+    lcd_cgram_add_holder(lcd_frame_cgram_refs);
+}
+
+/**
+ * @brief Writes a string into the back buffer
+ *
+ * @param row Row position (0 or 1)
+ * @param column Column position (0 to 15)
+ * @param str Pointer to the string to be written
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_frame_print(uint8_t row, uint8_t column, const char *str)
+{
+    if (row >= LCD_ROWS || column >= LCD_COLUMNS || str == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    lcd_frame_prepare();
+    while (*str && column < LCD_COLUMNS)
+    {
+        frame_back.cells[row][column++] = (uint8_t)*str++;
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Presents the back buffer
+ *
+ * This function copies the back buffer into the pending slot with
+ * interrupts masked, replacing any frame still waiting there. From thread
+ * context it then transmits the pending frame; from interrupt context it
+ * leaves that to lcd_frame_service() or to the present it interrupted.
+ *
+ * @return LCD_SUCCESS if the frame was transmitted, LCD_ERR_BUSY if it was queued
+ */
+int lcd_frame_present(void)
+{
+    lcd_frame_prepare();
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    frame_pending = frame_back;
+    frame_pending_valid = true;
+    __set_PRIMASK(primask);
+
+    if (__get_IPSR() != 0)
+    {
+        return LCD_ERR_BUSY;
+    }
+    return lcd_frame_service();
+}
+
+/**
+ * @brief Transmits the pending frame
+ *
+ * This function sends the pending frame row by row. If a newer frame is
+ * queued in the meantime, it starts over with that one; rows already sent
+ * are skipped by the shadow diff.
+ *
+ * @return LCD_SUCCESS if no frame is waiting or it was transmitted, LCD_ERR_BUSY if busy
+ */
+int lcd_frame_service(void)
+{
+    struct lcd_frame frame;
+    int ret = LCD_SUCCESS;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool busy = frame_transmitting;
+    frame_transmitting = true;
+    __set_PRIMASK(primask);
+
+    if (busy)
+    {
+        return LCD_ERR_BUSY;
+    }
+
+    while (ret == LCD_SUCCESS && lcd_frame_take(&frame))
+    {
+        for (uint8_t row = 0; row < LCD_ROWS && !frame_pending_valid; row++)
+        {
+            ret = lcd_update_row(row, 0, frame.cells[row], LCD_COLUMNS);
+            if (ret != LCD_SUCCESS)
+            {
+                /* Put the frame back unless a newer one replaced it */
+                __disable_irq();
+                if (!frame_pending_valid)
+                {
+                    frame_pending = frame;
+                    frame_pending_valid = true;
+                }
+                __set_PRIMASK(primask);
+                break;
+            }
+        }
+    }
+
+    frame_transmitting = false;
+    return ret;
+}
+
+/* Private functions */
+
+/**
+ * @brief Fills the back buffer with spaces before its first use
+ */
+static void lcd_frame_prepare(void)
+{
+    if (!frame_back_ready)
+    {
+        lcd_frame_clear();
+    }
+}
+
+/**
+ * @brief Moves the pending frame out of the pending slot
+ *
+ * @param frame Pointer receiving the frame
+ * @return true if a frame was pending
+ */
+static bool lcd_frame_take(struct lcd_frame *frame)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool valid = frame_pending_valid;
+    if (valid)
+    {
+        *frame = frame_pending;
+        frame_pending_valid = false;
+    }
+    __set_PRIMASK(primask);
+    return valid;
+}
+
+/**
+ * @brief Collects the CGRAM locations referenced by the back and pending frames
+ *
+ * @return Bit mask of referenced locations
+ */
+static uint8_t lcd_frame_cgram_refs(void)
+{
+    uint8_t used = lcd_cgram_refs(&frame_back.cells[0][0], sizeof(frame_back.cells));
+
+    if (frame_pending_valid)
+    {
+        used |= lcd_cgram_refs(&frame_pending.cells[0][0], sizeof(frame_pending.cells));
+    }
+    return used;
+}
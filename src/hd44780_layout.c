@@ -0,0 +1,334 @@
+/**
+ * @file
+ * @brief Text layout for LCD 16x2 Display Driver
+ *
+ * This file provides greedy word-wrap with alignment, ellipsis and
+ * pagination on top of the window compositor. A layout is the list of
+ * line spans into the text; it is cached together with a copy of the text,
+ * the window width and the style. A hash of the text rejects most entries
+ * before the copy is compared, so a message shown again only costs the
+ * hash, one comparison and the copy into the window, and the window dirty
+ * tracking limits the display update to the changed cells.
+ */
+
+#include "hd44780_layout.h"
+#include <string.h>
+
+/* Span of a laid out line within the text */
+struct lcd_layout_line
+{
+    uint16_t start;
+    uint8_t len;
+};
+
+/* Cached layout */
+struct lcd_layout
+{
+    uint32_t hash;
+    uint16_t text_len;
+    uint8_t width;
+    uint8_t style;
+    uint8_t line_count;
+    uint16_t truncated; /* Lines that were cut off, one bit per line */
+    struct lcd_layout_line lines[LCD_LAYOUT_MAX_LINES];
+    char text[LCD_LAYOUT_CACHE_TEXT]; /* Copy of the text, cached entries only */
+};
+
+static struct lcd_layout layout_cache[LCD_LAYOUT_CACHE_SIZE];
+static uint8_t layout_cache_next;
+
+/* Private function prototypes */
+static uint32_t lcd_layout_hash(const char *text, size_t len);
+static uint8_t lcd_layout_style_bits(const struct lcd_layout_style *style);
+static void lcd_layout_compute(struct lcd_layout *layout, const char *text, const struct lcd_layout_style *style);
+static bool lcd_layout_add(struct lcd_layout *layout, size_t start, size_t len, bool truncated);
+static void lcd_layout_render(uint8_t *line, uint8_t width, const char *text,
+                              const struct lcd_layout *layout, uint8_t index, const struct lcd_layout_style *style);
+
+/**
+ * @brief Lays text out in a window
+ *
+ * This function looks the layout up in the cache, computing and caching it
+ * if needed, and writes the requested page into the window. Texts longer
+ * than LCD_LAYOUT_CACHE_TEXT are laid out without the cache.
+ *
+ * @param win Pointer to the window structure
+ * @param text Pointer to the text
+ * @param style Pointer to the layout style structure
+ * @param page Page to show, starting at 0
+ * @param page_count Pointer receiving the number of pages, may be NULL
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_layout_show(struct lcd_window *win, const char *text, const struct lcd_layout_style *style,
+                    uint8_t page, uint8_t *page_count)
+{
+    if (win == NULL || text == NULL || style == NULL || !lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    size_t len = strlen(text);
+    if (len > UINT16_MAX)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    uint32_t hash = lcd_layout_hash(text, len);
+    uint8_t style_bits = lcd_layout_style_bits(style);
+    struct lcd_layout *layout = NULL;
+    struct lcd_layout uncached;
+
+    if (len <= LCD_LAYOUT_CACHE_TEXT)
+    {
+        for (int i = 0; i < LCD_LAYOUT_CACHE_SIZE; i++)
+        {
+            struct lcd_layout *entry = &layout_cache[i];
+            if (entry->width == win->width && entry->hash == hash && entry->text_len == len &&
+                entry->style == style_bits && memcmp(entry->text, text, len) == 0)
+            {
+                layout = entry;
+                break;
+            }
+        }
+    }
+
+    if (layout == NULL)
+    {
+        if (len <= LCD_LAYOUT_CACHE_TEXT)
+        {
+            layout = &layout_cache[layout_cache_next];
+            layout_cache_next = (layout_cache_next + 1) % LCD_LAYOUT_CACHE_SIZE;
+            memcpy(layout->text, text, len);
+        }
+        else
+        {
+            layout = &uncached;
+        }
+
+        layout->hash = hash;
+        layout->text_len = (uint16_t)len;
+        layout->width = win->width;
+        layout->style = style_bits;
+        lcd_layout_compute(layout, text, style);
+    }
+
+    uint8_t pages = (layout->line_count + win->height - 1) / win->height;
+    if (pages == 0)
+    {
+        pages = 1;
+    }
+    if (page >= pages)
+    {
+        return LCD_ERR_PARAM;
+    }
+    if (page_count != NULL)
+    {
+        *page_count = pages;
+    }
+
+    uint8_t line[LCD_COLUMNS];
+    for (uint8_t row = 0; row < win->height; row++)
+    {
+        lcd_layout_render(line, win->width, text, layout, page * win->height + row, style);
+        lcd_window_write(win, row, 0, line, win->width);
+    }
+    return LCD_SUCCESS;
+}
+
+/* Private functions */
+
+/**
+ * @brief Hashes the text with 32-bit FNV-1a
+ *
+ * @param text Pointer to the text
+ * @param len Length of the text
+ * @return Hash value
+ */
+static uint32_t lcd_layout_hash(const char *text, size_t len)
+{
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/**
+ * @brief Packs the parts of a style that affect line breaking
+ *
+ * Alignment only matters when rendering, so it is left out and layouts are
+ * shared between alignments.
+ *
+ * @param style Pointer to the layout style structure
+ * @return Style bits used as part of the cache key
+ */
+static uint8_t lcd_layout_style_bits(const struct lcd_layout_style *style)
+{
+    return style->wrap ? 0x01 : 0x00;
+}
+
+/**
+ * @brief Breaks the text into lines
+ *
+ * Lines end at newlines. With wrap, longer lines are broken after the last
+ * space that fits, or split at the width if a word is longer than a line;
+ * spaces at a break are dropped. Without wrap, longer lines are cut off.
+ * Text beyond LCD_LAYOUT_MAX_LINES is cut off as well.
+ *
+ * @param layout Pointer to the layout being computed
+ * @param text Pointer to the text
+ * @param style Pointer to the layout style structure
+ */
+static void lcd_layout_compute(struct lcd_layout *layout, const char *text, const struct lcd_layout_style *style)
+{
+    size_t width = layout->width;
+    size_t len = layout->text_len;
+    size_t pos = 0;
+
+    layout->line_count = 0;
+    layout->truncated = 0;
+
+    while (pos < len)
+    {
+        const char *newline = memchr(&text[pos], '\n', len - pos);
+        size_t end = newline != NULL ? (size_t)(newline - text) : len;
+
+        if (!style->wrap)
+        {
+            if (!lcd_layout_add(layout, pos, end - pos, end - pos > width))
+            {
+                return;
+            }
+            pos = end + 1;
+            continue;
+        }
+
+        while (end - pos > width)
+        {
+            size_t brk = pos + width;
+            while (brk > pos && text[brk] != ' ')
+            {
+                brk--;
+            }
+
+            size_t next;
+            if (brk == pos)
+            {
+                /* No space to break at, split the word */
+                brk = pos + width;
+                next = brk;
+            }
+            else
+            {
+                next = brk + 1;
+            }
+
+            /* Drop the spaces around the break */
+            while (brk > pos && text[brk - 1] == ' ')
+            {
+                brk--;
+            }
+            while (next < end && text[next] == ' ')
+            {
+                next++;
+            }
+
+            if (!lcd_layout_add(layout, pos, brk - pos, false))
+            {
+                return;
+            }
+            pos = next;
+        }
+
+        if (!lcd_layout_add(layout, pos, end - pos, false))
+        {
+            return;
+        }
+        pos = end + 1;
+    }
+}
+
+/**
+ * @brief Appends a line to the layout
+ *
+ * If the layout is full, the last line is marked as cut off instead.
+ *
+ * @param layout Pointer to the layout being computed
+ * @param start Offset of the line in the text
+ * @param len Length of the line
+ * @param truncated Line is longer than the window width
+ * @return true if the line was added, false if the layout is full
+ */
+static bool lcd_layout_add(struct lcd_layout *layout, size_t start, size_t len, bool truncated)
+{
+    if (layout->line_count == LCD_LAYOUT_MAX_LINES)
+    {
+        layout->truncated |= 1U << (LCD_LAYOUT_MAX_LINES - 1);
+        return false;
+    }
+
+    if (len > layout->width)
+    {
+        len = layout->width;
+    }
+
+    uint8_t index = layout->line_count++;
+    layout->lines[index].start = (uint16_t)start;
+    layout->lines[index].len = (uint8_t)len;
+    if (truncated)
+    {
+        layout->truncated |= 1U << index;
+    }
+    return true;
+}
+
+/**
+ * @brief Renders one laid out line into a window row
+ *
+ * @param line Buffer receiving width character codes
+ * @param width Window width
+ * @param text Pointer to the text
+ * @param layout Pointer to the layout
+ * @param index Line to render; lines past the end render blank
+ * @param style Pointer to the layout style structure
+ */
+static void lcd_layout_render(uint8_t *line, uint8_t width, const char *text,
+                              const struct lcd_layout *layout, uint8_t index, const struct lcd_layout_style *style)
+{
+    memset(line, ' ', width);
+    if (index >= layout->line_count)
+    {
+        return;
+    }
+
+    uint8_t len = layout->lines[index].len;
+    uint8_t mark = 0;
+    if (style->ellipsis && (layout->truncated & (1U << index)))
+    {
+        mark = sizeof(LCD_LAYOUT_ELLIPSIS) - 1;
+        if (mark > width)
+        {
+            mark = width;
+        }
+        if (len > width - mark)
+        {
+            len = width - mark;
+        }
+    }
+
+    uint8_t total = len + mark;
+    uint8_t offset = 0;
+    if (style->align == LCD_ALIGN_CENTER)
+    {
+        offset = (width - total) / 2;
+    }
+    else if (style->align == LCD_ALIGN_RIGHT)
+    {
+        offset = width - total;
+    }
+
+    memcpy(&line[offset], &text[layout->lines[index].start], len);
+    memcpy(&line[offset + len], LCD_LAYOUT_ELLIPSIS, mark);
+}
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @brief Pre-encoded static screens for LCD 16x2 Display Driver
+ *
+ * This file provides replay of screen streams. Runs in a stream already
+ * carry the DDRAM address instruction, so decoding a run is a couple of
+ * comparisons before its characters are handed to the bulk write or the
+ * shadow diff of the driver.
+ */
+
+#include "hd44780_screen.h"
+#include "hd44780defs.h"
+
+/* Private function prototypes */
+static int lcd_screen_run(const uint8_t *stream, bool diff);
+static bool lcd_screen_decode(const uint8_t *stream, uint8_t *row, uint8_t *column);
+
+/**
+ * @brief Replays a screen stream
+ *
+ * @param stream Screen stream
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid stream, LCD_ERR_BUSY if LCD is busy
+ */
+int lcd_screen_play(const uint8_t *stream)
+{
+    return lcd_screen_run(stream, false);
+}
+
+/**
+ * @brief Loads a screen stream, updating only cells that differ
+ *
+ * @param stream Screen stream
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid stream, LCD_ERR_BUSY if LCD is busy
+ */
+int lcd_screen_load(const uint8_t *stream)
+{
+    return lcd_screen_run(stream, true);
+}
+
+/* Private functions */
+
+/**
+ * @brief Walks a screen stream and writes its runs
+ *
+ * The whole stream is checked before the first run is written, so an
+ * invalid stream leaves the display untouched.
+ *
+ * @param stream Screen stream
+ * @param diff Write only characters that differ from the display shadow (true) or all (false)
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid stream, LCD_ERR_BUSY if LCD is busy
+ */
+static int lcd_screen_run(const uint8_t *stream, bool diff)
+{
+    if (stream == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    uint8_t row;
+    uint8_t column;
+
+    for (const uint8_t *run = stream; *run != LCD_SCREEN_END; run += 2 + run[1])
+    {
+        if (!lcd_screen_decode(run, &row, &column))
+        {
+            return LCD_ERR_PARAM;
+        }
+    }
+
+    for (; *stream != LCD_SCREEN_END; stream += 2 + stream[1])
+    {
+        lcd_screen_decode(stream, &row, &column);
+
+        uint8_t len = stream[1];
+        const uint8_t *cells = &stream[2];
+        int ret = diff ? lcd_update_row(row, column, cells, len) : lcd_write_buffer(row, column, cells, len);
+        if (ret != LCD_SUCCESS)
+        {
+            return ret;
+        }
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Decodes and checks the header of a run
+ *
+ * @param stream Run header: address instruction and length
+ * @param row Pointer receiving the row
+ * @param column Pointer receiving the column
+ * @return true if the run lies within one display row
+ */
+static bool lcd_screen_decode(const uint8_t *stream, uint8_t *row, uint8_t *column)
+{
+    uint8_t address = stream[0] & LCD_DDRAM_ADDR_MASK;
+    uint8_t len = stream[1];
+
+    *row = address >= LCD_ROW_OFFSET_1 ? 1 : 0;
+    *column = address - (*row ? LCD_ROW_OFFSET_1 : LCD_ROW_OFFSET_0);
+
+    /* Runs never wrap, they end on the row they start on */
+    return (stream[0] & LCD_CMD_DDRAM_ADDR) && *column < LCD_COLUMNS && len <= LCD_COLUMNS - *column;
+}
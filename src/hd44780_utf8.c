@@ -0,0 +1,345 @@
+/**
+ * @file
+ * @brief UTF-8 text support for LCD 16x2 Display Driver
+ *
+ * This file provides UTF-8 decoding and translation to the character ROM
+ * of HD44780-compatible controllers. ROM lookups go through the generated
+ * three-level tables in hd44780_rom_tables.h, so translating a character
+ * costs a fixed number of table reads regardless of the script used.
+ */
+
+#include "hd44780_utf8.h"
+#include "hd44780defs.h"
+#include "hd44780_rom_tables.h"
+
+/* ROM lookup tables, see tools/gen_rom_tables.py */
+struct lcd_rom_map
+{
+    const uint8_t *pages;
+    const uint8_t (*blocks)[4];
+    const uint8_t (*cells)[64];
+};
+
+static const struct lcd_rom_map lcd_rom_maps[] = {
+    [LCD_ROM_A00] = {lcd_rom_a00_pages, lcd_rom_a00_blocks, lcd_rom_a00_cells},
+    [LCD_ROM_A02] = {lcd_rom_a02_pages, lcd_rom_a02_blocks, lcd_rom_a02_cells},
+};
+
+/* CGRAM fallback glyph slots */
+struct lcd_utf8_slot
+{
+    uint32_t codepoint; /* 0 if the slot is free */
+    uint32_t last_used;
+};
+
+static struct lcd_utf8_config utf8_config = {.rom = LCD_ROM_A00};
+static struct lcd_utf8_slot utf8_slots[LCD_CGRAM_CHARS];
+static uint32_t utf8_use_counter;
+
+/* Private function prototypes */
+static uint32_t lcd_utf8_decode(const char **str);
+static uint8_t lcd_utf8_rom_lookup(uint32_t codepoint);
+static int lcd_utf8_find_glyph(uint32_t codepoint);
+static int lcd_utf8_load_glyph(uint32_t codepoint, uint8_t *code);
+static int lcd_utf8_flush(uint8_t *run, uint8_t *len);
+
+/**
+ * @brief Configures UTF-8 translation
+ *
+ * This function selects the character ROM and the CGRAM locations reserved
+ * for fallback glyphs. Previously loaded fallback glyphs are forgotten.
+ *
+ * @param config Pointer to the UTF-8 configuration structure
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_utf8_init(const struct lcd_utf8_config *config)
+{
+    if (config == NULL || config->rom > LCD_ROM_A02 ||
+        config->first_slot + config->slot_count > LCD_CGRAM_CHARS)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    utf8_config = *config;
+    for (int i = 0; i < LCD_CGRAM_CHARS; i++)
+    {
+        utf8_slots[i].codepoint = 0;
+        utf8_slots[i].last_used = 0;
+    }
+    utf8_use_counter = 0;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Translates a codepoint to a character code
+ *
+ * This function looks the codepoint up in the ROM tables and, if it is
+ * missing, in the CGRAM fallback glyphs, loading a new glyph if needed.
+ *
+ * @param codepoint Unicode codepoint
+ * @param code Pointer receiving the character code
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters, LCD_ERR_BUSY if LCD is busy
+ */
+int lcd_utf8_translate(uint32_t codepoint, uint8_t *code)
+{
+    if (code == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    *code = lcd_utf8_rom_lookup(codepoint);
+    if (*code != 0)
+    {
+        return LCD_SUCCESS;
+    }
+
+    return lcd_utf8_load_glyph(codepoint, code);
+}
+
+/**
+ * @brief Writes a UTF-8 string to the LCD
+ *
+ * This function decodes the string, translates every codepoint and writes
+ * the resulting character codes at the current cursor position. The codes
+ * are collected and sent as bulk data runs like ASCII strings; a run is cut
+ * short only where a glyph has to be loaded into CGRAM. Malformed sequences
+ * are shown as LCD_UTF8_REPLACEMENT.
+ *
+ * @param str Pointer to the UTF-8 string to be written
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if the string is NULL, LCD_ERR_BUSY if LCD is busy
+ */
+int lcd_write_utf8(const char *str)
+{
+    if (str == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    uint8_t run[LCD_COLUMNS + 1];
+    uint8_t len = 0;
+
+    while (*str)
+    {
+        uint32_t codepoint = lcd_utf8_decode(&str);
+        uint8_t code = lcd_utf8_rom_lookup(codepoint);
+
+        if (code == 0)
+        {
+            /* Loading a glyph moves the address, send what precedes it first */
+            if (lcd_utf8_find_glyph(codepoint) < 0)
+            {
+                int ret = lcd_utf8_flush(run, &len);
+                if (ret != LCD_SUCCESS)
+                {
+                    return ret;
+                }
+            }
+
+            int ret = lcd_utf8_load_glyph(codepoint, &code);
+            if (ret != LCD_SUCCESS)
+            {
+                return ret;
+            }
+        }
+
+        /* Code 0 would end the run, use its CGRAM alias instead */
+        run[len++] = code != 0 ? code : LCD_CGRAM_CHARS;
+        if (len == LCD_COLUMNS)
+        {
+            int ret = lcd_utf8_flush(run, &len);
+            if (ret != LCD_SUCCESS)
+            {
+                return ret;
+            }
+        }
+    }
+    return lcd_utf8_flush(run, &len);
+}
+
+/* Private functions */
+
+/**
+ * @brief Decodes the next codepoint of a UTF-8 string
+ *
+ * Overlong, truncated and out-of-range sequences decode to U+FFFD.
+ *
+ * @param str Pointer to the string position, advanced past the sequence
+ * @return Decoded codepoint
+ */
+static uint32_t lcd_utf8_decode(const char **str)
+{
+    const uint8_t *s = (const uint8_t *)*str;
+    uint32_t codepoint;
+    uint32_t min;
+    int extra;
+
+    if (s[0] < 0x80)
+    {
+        *str += 1;
+        return s[0];
+    }
+    else if ((s[0] & 0xE0) == 0xC0)
+    {
+        codepoint = s[0] & 0x1F;
+        min = 0x80;
+        extra = 1;
+    }
+    else if ((s[0] & 0xF0) == 0xE0)
+    {
+        codepoint = s[0] & 0x0F;
+        min = 0x800;
+        extra = 2;
+    }
+    else if ((s[0] & 0xF8) == 0xF0)
+    {
+        codepoint = s[0] & 0x07;
+        min = 0x10000;
+        extra = 3;
+    }
+    else
+    {
+        *str += 1;
+        return 0xFFFD;
+    }
+
+    for (int i = 1; i <= extra; i++)
+    {
+        /* Also stops at the terminating NUL */
+        if ((s[i] & 0xC0) != 0x80)
+        {
+            *str += i;
+            return 0xFFFD;
+        }
+        codepoint = (codepoint << 6) | (s[i] & 0x3F);
+    }
+
+    *str += extra + 1;
+    if (codepoint < min || codepoint > 0x10FFFF)
+    {
+        return 0xFFFD;
+    }
+    return codepoint;
+}
+
+/**
+ * @brief Looks a codepoint up in the ROM tables
+ *
+ * @param codepoint Unicode codepoint
+ * @return ROM character code, 0 if the codepoint is not in ROM
+ */
+static uint8_t lcd_utf8_rom_lookup(uint32_t codepoint)
+{
+    const struct lcd_rom_map *map = &lcd_rom_maps[utf8_config.rom];
+
+    if (codepoint > 0xFFFF)
+    {
+        return 0;
+    }
+    return map->cells[map->blocks[map->pages[codepoint >> 8]][(codepoint >> 6) & 0x03]][codepoint & 0x3F];
+}
+
+/**
+ * @brief Finds the CGRAM slot holding the glyph for a codepoint
+ *
+ * @param codepoint Unicode codepoint
+ * @return Slot number, -1 if the glyph is not loaded
+ */
+static int lcd_utf8_find_glyph(uint32_t codepoint)
+{
+    uint8_t first = utf8_config.first_slot;
+    uint8_t last = first + utf8_config.slot_count;
+
+    for (uint8_t slot = first; slot < last; slot++)
+    {
+        if (utf8_slots[slot].codepoint == codepoint)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Finds or loads the CGRAM glyph for a codepoint
+ *
+ * A new glyph goes to a free slot, or else replaces the least recently used
+ * glyph that is neither on the display nor held by a registered buffer. If no slot can be used the
+ * replacement character is returned instead.
+ *
+ * @param codepoint Unicode codepoint
+ * @param code Pointer receiving the character code
+ * @return LCD_SUCCESS if successful, LCD_ERR_BUSY if LCD is busy
+ */
+static int lcd_utf8_load_glyph(uint32_t codepoint, uint8_t *code)
+{
+    uint8_t first = utf8_config.first_slot;
+    uint8_t last = first + utf8_config.slot_count;
+    int victim = -1;
+
+    *code = LCD_UTF8_REPLACEMENT;
+
+    int loaded = lcd_utf8_find_glyph(codepoint);
+    if (loaded >= 0)
+    {
+        utf8_slots[loaded].last_used = ++utf8_use_counter;
+        *code = (uint8_t)loaded;
+        return LCD_SUCCESS;
+    }
+
+    const uint8_t *pattern = utf8_config.glyph != NULL ? utf8_config.glyph(codepoint) : NULL;
+    if (pattern == NULL)
+    {
+        return LCD_SUCCESS;
+    }
+
+    /* Glyphs shown or waiting in a buffer must not change under the user's eyes */
+    uint8_t visible = lcd_cgram_in_use();
+
+    for (uint8_t slot = first; slot < last; slot++)
+    {
+        if (utf8_slots[slot].codepoint == 0)
+        {
+            victim = slot;
+            break;
+        }
+        if (!(visible & (1U << slot)) &&
+            (victim < 0 || utf8_slots[slot].last_used < utf8_slots[victim].last_used))
+        {
+            victim = slot;
+        }
+    }
+    if (victim < 0)
+    {
+        return LCD_SUCCESS;
+    }
+
+    int ret = lcd_create_char((uint8_t)victim, pattern);
+    if (ret != LCD_SUCCESS)
+    {
+        return ret;
+    }
+
+    utf8_slots[victim].codepoint = codepoint;
+    utf8_slots[victim].last_used = ++utf8_use_counter;
+    *code = (uint8_t)victim;
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Sends the collected character codes as one data run
+ *
+ * @param run Character codes, with room for a terminator
+ * @param len Pointer to the number of codes, reset to 0
+ * @return LCD_SUCCESS if successful, LCD_ERR_BUSY if LCD is busy
+ */
+static int lcd_utf8_flush(uint8_t *run, uint8_t *len)
+{
+    if (*len == 0)
+    {
+        return LCD_SUCCESS;
+    }
+
+    run[*len] = '\0';
+    *len = 0;
+    return lcd_write_string((const char *)run);
+}
@@ -0,0 +1,381 @@
+/**
+ * @file
+ * @brief Window compositor for LCD 16x2 Display Driver
+ *
+ * This file provides rectangular windows with clipping and z-order that
+ * are composited into a single display image. Each window tracks which of
+ * its cells changed; window level changes (open, close, show, z-order)
+ * damage the covered display area. A flush composites only damaged cells
+ * and hands them to lcd_update_row(), which transmits what differs from
+ * the display shadow.
+ */
+
+#include "hd44780_window.h"
+#include <string.h>
+
+/* Open windows, front to back */
+static struct lcd_window *window_list;
+
+/* Display cells to be recomposited, one bit per column */
+static uint32_t window_damage[LCD_ROWS];
+
+/* Private function prototypes */
+static void lcd_window_link(struct lcd_window *win);
+static void lcd_window_unlink(struct lcd_window *win);
+static void lcd_window_damage(const struct lcd_window *win);
+static uint8_t lcd_window_compose(uint8_t row, uint8_t column, uint8_t background);
+static uint8_t lcd_window_cgram_refs(void);
+
+/**
+ * @brief Opens a window
+ *
+ * This function sets up the window structure, fills the contents with
+ * spaces and inserts it into the stacking order.
+ *
+ * @param win Pointer to the window structure
+ * @param row Top row on the display
+ * @param column Left column on the display
+ * @param height Height in rows
+ * @param width Width in columns
+ * @param z Stacking order, higher is in front
+ * @param cells Buffer of height * width bytes for the window contents
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_open(struct lcd_window *win, uint8_t row, uint8_t column, uint8_t height, uint8_t width,
+                    uint8_t z, uint8_t *cells)
+{
+    if (win == NULL || cells == NULL || height == 0 || width == 0 ||
+        row >= LCD_ROWS || column >= LCD_COLUMNS ||
+        height > LCD_ROWS - row || width > LCD_COLUMNS - column ||
+        lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    win->row = row;
+    win->column = column;
+    win->height = height;
+    win->width = width;
+    win->z = z;
+    win->visible = true;
+    win->cells = cells;
+    memset(cells, ' ', (size_t)height * width);
+    memset(win->dirty, 0, sizeof(win->dirty));
+
+    lcd_window_link(win);
+    lcd_window_damage(win);
+    lcd_cgram_add_holder(lcd_window_cgram_refs);
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Closes a window
+ *
+ * This function removes the window from the stacking order. The area it
+ * covered is recomposited on the next flush.
+ *
+ * @param win Pointer to the window structure
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_close(struct lcd_window *win)
+{
+    if (win == NULL || !lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    lcd_window_unlink(win);
+    lcd_window_damage(win);
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Shows or hides a window
+ *
+ * @param win Pointer to the window structure
+ * @param visible Show the window (true) or hide it (false)
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_show(struct lcd_window *win, bool visible)
+{
+    if (win == NULL || !lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    if (win->visible != visible)
+    {
+        win->visible = visible;
+        lcd_window_damage(win);
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Changes the stacking order of a window
+ *
+ * @param win Pointer to the window structure
+ * @param z Stacking order, higher is in front
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_set_z(struct lcd_window *win, uint8_t z)
+{
+    if (win == NULL || !lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    lcd_window_unlink(win);
+    win->z = z;
+    lcd_window_link(win);
+    lcd_window_damage(win);
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Writes character codes into a window
+ *
+ * This function copies the characters into the window contents, clipping
+ * at the right edge, and marks the cells that actually changed.
+ *
+ * @param win Pointer to the window structure
+ * @param row Row within the window
+ * @param column Column within the window
+ * @param buf Character codes to write
+ * @param len Number of characters
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_write(struct lcd_window *win, uint8_t row, uint8_t column, const uint8_t *buf, size_t len)
+{
+    if (win == NULL || buf == NULL || !lcd_window_is_open(win) ||
+        row >= win->height || column >= win->width)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    if (len > (size_t)(win->width - column))
+    {
+        len = win->width - column;
+    }
+
+    uint8_t *cells = &win->cells[row * win->width + column];
+    for (size_t i = 0; i < len; i++)
+    {
+        if (cells[i] != buf[i])
+        {
+            cells[i] = buf[i];
+            win->dirty[row] |= 1UL << (column + i);
+        }
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Writes a string into a window
+ *
+ * @param win Pointer to the window structure
+ * @param row Row within the window
+ * @param column Column within the window
+ * @param str Pointer to the string to be written
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_print(struct lcd_window *win, uint8_t row, uint8_t column, const char *str)
+{
+    if (str == NULL)
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    return lcd_window_write(win, row, column, (const uint8_t *)str, strlen(str));
+}
+
+/**
+ * @brief Fills a window with a character
+ *
+ * @param win Pointer to the window structure
+ * @param c Character code to fill with
+ * @return LCD_SUCCESS if successful, LCD_ERR_PARAM if invalid parameters
+ */
+int lcd_window_fill(struct lcd_window *win, uint8_t c)
+{
+    if (win == NULL || !lcd_window_is_open(win))
+    {
+        return LCD_ERR_PARAM;
+    }
+
+    uint8_t line[LCD_COLUMNS];
+    memset(line, c, sizeof(line));
+    for (uint8_t row = 0; row < win->height; row++)
+    {
+        lcd_window_write(win, row, 0, line, win->width);
+    }
+    return LCD_SUCCESS;
+}
+
+/**
+ * @brief Checks whether a window is in the stacking order
+ *
+ * @param win Pointer to the window structure
+ * @return true if the window is open
+ */
+bool lcd_window_is_open(const struct lcd_window *win)
+{
+    for (const struct lcd_window *it = window_list; it != NULL; it = it->next)
+    {
+        if (it == win)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Composites all windows and updates the display
+ *
+ * This function collects the changed cells of all visible windows, then
+ * recomposites the damaged cells of each row and passes the damaged span
+ * to lcd_update_row(). Cells not covered by any window show a space.
+ *
+ * @return LCD_SUCCESS if successful, LCD_ERR_BUSY if LCD is busy
+ */
+int lcd_window_flush(void)
+{
+    for (struct lcd_window *win = window_list; win != NULL; win = win->next)
+    {
+        for (uint8_t row = 0; row < win->height; row++)
+        {
+            if (win->visible)
+            {
+                window_damage[win->row + row] |= win->dirty[row] << win->column;
+            }
+            win->dirty[row] = 0;
+        }
+    }
+
+    for (uint8_t row = 0; row < LCD_ROWS; row++)
+    {
+        uint32_t damage = window_damage[row];
+        if (damage == 0)
+        {
+            continue;
+        }
+
+        uint8_t line[LCD_COLUMNS];
+        uint8_t first = LCD_COLUMNS;
+        uint8_t last = 0;
+        for (uint8_t col = 0; col < LCD_COLUMNS; col++)
+        {
+            lcd_get_char(row, col, &line[col]);
+            if (damage & (1UL << col))
+            {
+                line[col] = lcd_window_compose(row, col, ' ');
+                if (first == LCD_COLUMNS)
+                {
+                    first = col;
+                }
+                last = col;
+            }
+        }
+
+        int ret = lcd_update_row(row, first, &line[first], last - first + 1);
+        if (ret != LCD_SUCCESS)
+        {
+            return ret;
+        }
+        window_damage[row] = 0;
+    }
+    return LCD_SUCCESS;
+}
+
+/* Private functions */
+
+/**
+ * @brief Inserts a window into the stacking order
+ *
+ * Windows are kept front to back; among equal z the newest is in front.
+ *
+ * @param win Pointer to the window structure
+ */
+static void lcd_window_link(struct lcd_window *win)
+{
+    struct lcd_window **link = &window_list;
+    while (*link != NULL && (*link)->z > win->z)
+    {
+        link = &(*link)->next;
+    }
+    win->next = *link;
+    *link = win;
+}
+
+/**
+ * @brief Removes a window from the stacking order
+ *
+ * @param win Pointer to the window structure
+ */
+static void lcd_window_unlink(struct lcd_window *win)
+{
+    for (struct lcd_window **link = &window_list; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == win)
+        {
+            *link = win->next;
+            win->next = NULL;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Marks the display area of a window for recompositing
+ *
+ * @param win Pointer to the window structure
+ */
+static void lcd_window_damage(const struct lcd_window *win)
+{
+    uint32_t mask = ((1UL << win->width) - 1) << win->column;
+    for (uint8_t row = 0; row < win->height; row++)
+    {
+        window_damage[win->row + row] |= mask;
+    }
+}
+
+/**
+ * @brief Composites a single display cell
+ *
+ * @param row Display row
+ * @param column Display column
+ * @param background Character code shown where no window is visible
+ * @return Character code of the frontmost visible window covering the cell
+ */
+static uint8_t lcd_window_compose(uint8_t row, uint8_t column, uint8_t background)
+{
+    for (const struct lcd_window *win = window_list; win != NULL; win = win->next)
+    {
+        if (win->visible &&
+            row >= win->row && row < win->row + win->height &&
+            column >= win->column && column < win->column + win->width)
+        {
+            return win->cells[(row - win->row) * win->width + (column - win->column)];
+        }
+    }
+    return background;
+}
+
+/**
+ * @brief Collects the CGRAM locations referenced by open windows
+ *
+ * Hidden windows count too, their contents reappear when shown.
+ *
+ * @return Bit mask of referenced locations
+ */
+static uint8_t lcd_window_cgram_refs(void)
+{
+    uint8_t used = 0;
+
+    for (const struct lcd_window *win = window_list; win != NULL; win = win->next)
+    {
+        used |= lcd_cgram_refs(win->cells, (size_t)win->height * win->width);
+    }
+    return used;
+}
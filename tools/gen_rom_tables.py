@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Generate the Unicode to HD44780 character ROM lookup tables.
+
+Writes src/hd44780_rom_tables.h with three-level tables for the A00
+(Japanese) and A02 (European) ROM variants, covering the Basic Multilingual
+Plane. A lookup is
+
+    cells[blocks[pages[cp >> 8]][(cp >> 6) & 3]][cp & 63]
+
+where 0 means the codepoint is not in ROM. Identical pages and blocks are
+shared, so the tables stay small while the lookup needs no searching.
+
+Usage: tools/gen_rom_tables.py [output]
+"""
+
+import sys
+import unicodedata
+
+BLOCK = 64
+BLOCKS_PER_PAGE = 256 // BLOCK
+
+
+def ascii_map(skip=()):
+    return {cp: cp for cp in range(0x20, 0x7F) if cp not in skip}
+
+
+def rom_a00():
+    m = ascii_map(skip=(0x5C, 0x7E))
+    m[0x00A5] = 0x5C  # YEN SIGN
+    m[0x2192] = 0x7E  # RIGHTWARDS ARROW
+    m[0x2190] = 0x7F  # LEFTWARDS ARROW
+    m[0x00A0] = 0x20  # NO-BREAK SPACE
+
+    # JIS X 0201 half-width katakana occupy 0xA1-0xDF, both the half-width
+    # forms and their full-width compatibility equivalents map there
+    for code in range(0xA1, 0xE0):
+        half = 0xFF61 + code - 0xA1
+        m[half] = code
+        full = unicodedata.normalize("NFKC", chr(half))
+        if len(full) == 1 and ord(full) != half:
+            m.setdefault(ord(full), code)
+    m[0x309B] = 0xDE  # KATAKANA-HIRAGANA VOICED SOUND MARK
+    m[0x309C] = 0xDF  # KATAKANA-HIRAGANA SEMI-VOICED SOUND MARK
+    m[0x00B0] = 0xDF  # DEGREE SIGN, customarily shown with the semi-voiced mark
+
+    for cp, code in (
+        (0x03B1, 0xE0),  # alpha
+        (0x00E4, 0xE1),  # a diaeresis
+        (0x03B2, 0xE2),  # beta
+        (0x00DF, 0xE2),  # sharp s
+        (0x03B5, 0xE3),  # epsilon
+        (0x03BC, 0xE4),  # mu
+        (0x00B5, 0xE4),  # micro sign
+        (0x03C3, 0xE5),  # sigma
+        (0x03C1, 0xE6),  # rho
+        (0x221A, 0xE8),  # square root
+        (0x00A2, 0xEC),  # cent
+        (0x00A3, 0xED),  # pound
+        (0x00F1, 0xEE),  # n tilde
+        (0x00F6, 0xEF),  # o diaeresis
+        (0x03B8, 0xF2),  # theta
+        (0x221E, 0xF3),  # infinity
+        (0x03A9, 0xF4),  # Omega
+        (0x2126, 0xF4),  # ohm sign
+        (0x00FC, 0xF5),  # u diaeresis
+        (0x03A3, 0xF6),  # Sigma
+        (0x03C0, 0xF7),  # pi
+        (0x5343, 0xFA),  # thousand
+        (0x4E07, 0xFB),  # ten thousand
+        (0x5186, 0xFC),  # yen
+        (0x00F7, 0xFD),  # division
+        (0x2588, 0xFF),  # full block
+    ):
+        m[cp] = code
+    return m
+
+
+def rom_a02():
+    m = ascii_map()
+    # The upper half of A02 follows ISO 8859-1
+    for cp in range(0xA0, 0x100):
+        m[cp] = cp
+    return m
+
+
+def build(mapping):
+    empty = (0,) * BLOCK
+    blocks = [empty]
+    block_ids = {empty: 0}
+    no_page = (0,) * BLOCKS_PER_PAGE
+    pages = [no_page]
+    page_ids = {no_page: 0}
+    page_index = []
+
+    for page in range(256):
+        ids = []
+        for b in range(BLOCKS_PER_PAGE):
+            base = (page << 8) | (b * BLOCK)
+            cells = tuple(mapping.get(base + i, 0) for i in range(BLOCK))
+            if cells not in block_ids:
+                block_ids[cells] = len(blocks)
+                blocks.append(cells)
+            ids.append(block_ids[cells])
+        ids = tuple(ids)
+        if ids not in page_ids:
+            page_ids[ids] = len(pages)
+            pages.append(ids)
+        page_index.append(page_ids[ids])
+
+    assert len(blocks) < 256 and len(pages) < 256
+    return page_index, pages, blocks
+
+
+def emit_array(out, decl, rows, width):
+    out.append(decl + " = {")
+    for row in rows:
+        out.append("    {")
+        for i in range(0, len(row), width):
+            chunk = ", ".join("0x%02X" % v for v in row[i:i + width])
+            out.append("        " + chunk + ",")
+        out.append("    },")
+    out.append("};")
+
+
+def emit_rom(out, name, mapping):
+    page_index, pages, blocks = build(mapping)
+    out.append("static const uint8_t lcd_rom_%s_pages[256] = {" % name)
+    for i in range(0, 256, 16):
+        out.append("    " + ", ".join("%d" % v for v in page_index[i:i + 16]) + ",")
+    out.append("};")
+    out.append("")
+    out.append("static const uint8_t lcd_rom_%s_blocks[%d][%d] = {" % (name, len(pages), BLOCKS_PER_PAGE))
+    for ids in pages:
+        out.append("    {" + ", ".join("%d" % v for v in ids) + "},")
+    out.append("};")
+    out.append("")
+    emit_array(out, "static const uint8_t lcd_rom_%s_cells[%d][%d]" % (name, len(blocks), BLOCK), blocks, 16)
+    out.append("")
+
+
+def main():
+    path = sys.argv[1] if len(sys.argv) > 1 else "src/hd44780_rom_tables.h"
+    out = [
+        "/**",
+        " * @file",
+        " * @brief Unicode to HD44780 character ROM lookup tables",
+        " *",
+        " * Generated by tools/gen_rom_tables.py, do not edit.",
+        " */",
+        "",
+        "#ifndef HD44780_ROM_TABLES_H_",
+        "#define HD44780_ROM_TABLES_H_",
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    emit_rom(out, "a00", rom_a00())
+    emit_rom(out, "a02", rom_a02())
+    out.append("#endif /* HD44780_ROM_TABLES_H_ */")
+    with open(path, "w") as f:
+        f.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Encode static LCD screens into streams for lcd_screen_play()/lcd_screen_load().
+
+Each input file holds one screen, one display row per line. Rows are padded
+with spaces to the display width. Characters equal to the hole character
+(--hole, default none) are left out of the stream, so fields filled in at
+runtime are not overwritten when the template is loaded.
+
+Usage: tools/gen_screen.py [--columns N] [--hole C] name=file.txt ... > screens.c
+"""
+
+import argparse
+import sys
+
+ROW_OFFSETS = (0x00, 0x40)
+
+
+def encode(lines, columns, hole):
+    stream = []
+    for row, text in enumerate(lines[:len(ROW_OFFSETS)]):
+        text = text.rstrip("\r\n").ljust(columns)[:columns]
+        data = text.encode("latin-1")
+        col = 0
+        while col < columns:
+            if hole is not None and text[col] == hole:
+                col += 1
+                continue
+            start = col
+            while col < columns and (hole is None or text[col] != hole):
+                col += 1
+            stream.append(0x80 | ROW_OFFSETS[row] | start)
+            stream.append(col - start)
+            stream.extend(data[start:col])
+    stream.append(0x00)
+    return stream
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--columns", type=int, default=16)
+    parser.add_argument("--hole", default=None)
+    parser.add_argument("screens", nargs="+", metavar="name=file")
+    args = parser.parse_args()
+
+    out = sys.stdout
+    out.write("/* Generated by tools/gen_screen.py, do not edit. */\n\n")
+    out.write("#include \"hd44780_screen.h\"\n")
+    for spec in args.screens:
+        name, path = spec.split("=", 1)
+        with open(path, encoding="latin-1") as f:
+            stream = encode(f.readlines(), args.columns, args.hole)
+        out.write("\nconst uint8_t %s[%d] = {\n" % (name, len(stream)))
+        for i in range(0, len(stream), 12):
+            out.write("    " + ", ".join("0x%02X" % b for b in stream[i:i + 12]) + ",\n")
+        out.write("};\n")
+
+
+if __name__ == "__main__":
+    main()